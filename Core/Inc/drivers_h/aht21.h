@@ -0,0 +1,40 @@
+/*
+ * aht21.h
+ *
+ *  Created on: 12-Jun-2023
+ *      Author: sunil
+ */
+
+#ifndef INC_AHT21_H_
+#define INC_AHT21_H_
+
+#include "main.h"
+#include "stm32l4xx_hal.h"
+
+extern I2C_HandleTypeDef hi2c3;
+#define AHT21_I2C_PORT hi2c3
+
+#define AHT21_MEASUREMENT_MS 80	// Datasheet conversion time after the 0xAC trigger
+
+typedef struct {
+	float temperature;	// degC
+	float humidity;		// %RH
+} AHT21_Data;
+
+HAL_StatusTypeDef AHT21_init(void);
+
+/*
+ * One trigger yields both values. Start a measurement, then call
+ * AHT21_GetMeasurement() at least AHT21_MEASUREMENT_MS later: it returns
+ * HAL_BUSY (without touching the bus before the conversion time) until the
+ * sensor clears its busy bit (or while another transfer holds the bus),
+ * HAL_OK with the data, or HAL_ERROR on a bus or CRC error and when no
+ * measurement was started.
+ */
+HAL_StatusTypeDef AHT21_StartMeasurement(void);
+HAL_StatusTypeDef AHT21_GetMeasurement(AHT21_Data *data);
+
+// Blocking trigger + wait + read, for init and tests
+HAL_StatusTypeDef AHT21_Read(AHT21_Data *data);
+
+#endif /* INC_AHT21_H_ */
@@ -21,21 +21,35 @@ void check_free_space(void);
 void black_box_init(void);
 void black_box_flush_all(void);
 
+/**
+ * Write full buffers to the card and sync on the time/byte budget.
+ * Call once per main-loop iteration, outside of timing-critical sections.
+ */
+void black_box_service(void);
+
 /**
  * Log an event.
  * Example: log_event(12,34,56,789,"INFO","System booted OK");
+ * With EVENT_LOG_TOKENIZED the message goes to events.bin as an EVT_TEXT
+ * record, stamped with the timebase instead of the given time.
  */
 void log_event(uint8_t hour, uint8_t min, uint8_t sec, uint16_t ms,
                const char* log_level, const char* message);
 
 /**
- * Log telemetry data.
- * Example: log_telemetry(12,34,56,789,23.1,1012.2,56.7,8.5,11.0,2,415,620,22.0,38.0);
+ * Append one encoded record to events.bin (EVENT_LOG_TOKENIZED, see tools_h/event_log.h).
+ */
+void black_box_write_event(const void* record, uint16_t len);
+
+/**
+ * Log telemetry data, stamped with a timebase_us() value.
+ * Example: log_telemetry(timebase_us(),23.1,1012.2,56.7,8.5,11.0,2,415,620,22.0,38.0,1.25);
  */
-void log_telemetry(uint8_t hour, uint8_t min, uint8_t sec, uint16_t ms,
+void log_telemetry(uint64_t timestamp_us,
                    float ms5607_temperature, float ms5607_pressure, float ms5607_altitude,
                    float sds011_pm2_5, float sds011_pm10,
                    float ens160_AQI, float ens160_TVOC, float ens160_eCO2,
-                   float aht21_temperature, float aht21_humidity);
+                   float aht21_temperature, float aht21_humidity,
+                   float mics5524_voltage);
 
 #endif /* INC_BLACKBOX_H_ */
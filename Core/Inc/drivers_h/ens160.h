@@ -3,6 +3,7 @@
 
 #include "stm32l4xx_hal.h" // Adjust if you use another STM32 series!
 #include <stdint.h>
+#include <stdbool.h>
 
 // ===== USER: SET YOUR I2C HANDLE HERE =====
 extern I2C_HandleTypeDef hi2c3;
@@ -27,6 +28,11 @@ extern I2C_HandleTypeDef hi2c3;
 #define ENS160_REG_GPR_WRITE       0x38
 // (Add others if needed, this covers most key registers.)
 
+// ====== ENS160 DATA_STATUS Bits ======
+#define ENS160_DATA_STATUS_NEWGPR  0x01
+#define ENS160_DATA_STATUS_NEWDAT  0x02
+#define ENS160_DATA_BLOCK_LEN      6            // DATA_STATUS, AQI, TVOC (2), ECO2 (2)
+
 // ====== ENS160 Operation Modes ======
 #define ENS160_OPMODE_RESET        0xF0
 #define ENS160_OPMODE_SLEEP        0x00
@@ -47,6 +53,13 @@ typedef enum {
     ENS160_AQI_UNHEALTHY = 5
 } ens160_aqi_t;
 
+// ====== ENS160 Asynchronous Transfer State ======
+typedef enum {
+    ENS160_XFER_IDLE = 0,
+    ENS160_XFER_STATUS,     // Reading DATA_STATUS
+    ENS160_XFER_DATA        // Reading AQI..ECO2
+} ens160_xfer_t;
+
 // ====== ENS160 Data Struct ======
 typedef struct {
     I2C_HandleTypeDef *i2c;
@@ -55,6 +68,10 @@ typedef struct {
     uint8_t aqi;
     uint16_t tvoc;
     uint16_t eco2;
+    volatile ens160_xfer_t xfer;
+    volatile bool new_data;             // Set by the completion callback, cleared by ENS160_DataAvailable()
+    uint8_t rx[ENS160_DATA_BLOCK_LEN];
+    uint32_t errors;
 } ENS160_t;
 
 // ====== ENS160 API ======
@@ -71,7 +88,13 @@ uint8_t  ENS160_SetMode(ENS160_t *dev, uint8_t mode);
 uint8_t  ENS160_SetTempAndRH(ENS160_t *dev, float temp_celsius, float rh_percent);
 
 // Data readout
-uint8_t  ENS160_ReadData(ENS160_t *dev); // Updates dev->aqi, tvoc, eco2
+uint8_t  ENS160_ReadData(ENS160_t *dev); // Blocking burst read, updates dev->aqi, tvoc, eco2
+
+// Interrupt-driven readout: DATA_STATUS first, the data block only when NEWDAT is set
+uint8_t  ENS160_StartRead(ENS160_t *dev);   // ENS160_ERROR if a read is still in flight
+bool     ENS160_DataAvailable(ENS160_t *dev);
+void     ENS160_I2C_MemRxCpltCallback(ENS160_t *dev, I2C_HandleTypeDef *hi2c);
+void     ENS160_I2C_ErrorCallback(ENS160_t *dev, I2C_HandleTypeDef *hi2c);
 uint8_t  ENS160_GetAQI(ENS160_t *dev, uint8_t *aqi);
 uint8_t  ENS160_GetTVOC(ENS160_t *dev, uint16_t *tvoc);
 uint8_t  ENS160_GetECO2(ENS160_t *dev, uint16_t *eco2);
@@ -0,0 +1,52 @@
+/*
+ * mics5524.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef INC_DRIVERS_H_MICS5524_H_
+#define INC_DRIVERS_H_MICS5524_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stm32l4xx_hal.h"
+
+/* ========================== */
+/*   MICS-5524 ACQUISITION    */
+/* ========================== */
+
+/*
+ * ADC1 channel 3 is converted on every TIM15 update (TRGO) with the
+ * hardware oversampler, into a circular DMA buffer split in two halves.
+ * Each half-transfer / transfer-complete interrupt averages the
+ * MICS5524_DECIMATION samples of the finished half into one output, so
+ * the CPU only sees MICS5524_TRIGGER_HZ / MICS5524_DECIMATION interrupts
+ * per second and never polls the ADC.
+ */
+
+typedef struct {
+    uint32_t outputs;       // Decimated outputs since start
+    float    voltage;       // Sensor output voltage (V)
+    float    ratio;         // Rs / R0, 0 until the clean-air baseline is captured
+} MICS5524_Reading;
+
+HAL_StatusTypeDef MICS5524_Init(void);
+HAL_StatusTypeDef MICS5524_Start(void);
+void MICS5524_Stop(void);
+
+/**
+ * Latest decimated output. Returns false before the first one.
+ */
+bool MICS5524_GetReading(MICS5524_Reading *reading);
+
+/**
+ * Use the mean of the next MICS5524_BASELINE_OUTPUTS outputs as R0.
+ * Called once at start, again whenever the air is known to be clean.
+ */
+void MICS5524_CaptureBaseline(void);
+
+void MICS5524_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc);
+void MICS5524_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+
+#endif /* INC_DRIVERS_H_MICS5524_H_ */
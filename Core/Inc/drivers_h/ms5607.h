@@ -85,6 +85,7 @@ struct MS5607Readings{
 };
 
 typedef struct {
+	uint64_t timestamp_us;	// End of the pressure conversion (tools_h/timebase.h)
 	float pressure;
 	float temperature;
 	float altitude;
@@ -112,12 +113,45 @@ void MS5607PromRead(struct promData *);
 
 /**
  * @brief  Reads uncompensated content from the MS5607 ADC
- * @note   Must be called before every convertion
+ * @note   Blocking: runs one conversion cycle and waits for it
  * @param  Address of MS5607 UncompensatedValues Structure
  * @retval None
  */
 void MS5607UncompensatedRead(struct MS5607UncompensatedValues *);
 
+/**
+ * @brief  Starts a D1 (pressure) then D2 (temperature) conversion cycle
+ * @note   Non-blocking. TIM6 waits the datasheet conversion time for the
+ *         selected OSR between steps and reads the ADC from its interrupt.
+ *         Does nothing if a cycle is already running.
+ * @param  None
+ * @retval None
+ */
+void MS5607StartConversion(void);
+
+/**
+ * @brief  Tells whether a conversion cycle has completed
+ * @param  None
+ * @retval 1 if D1 and D2 are available, 0 otherwise
+ */
+uint8_t MS5607ConversionReady(void);
+
+/**
+ * @brief  Conversion complete callback, called from the TIM6 interrupt
+ * @note   Weak, override to be notified instead of polling
+ * @param  None
+ * @retval None
+ */
+void MS5607ConversionCpltCallback(void);
+
+/**
+ * @brief  Steps the conversion state machine
+ * @note   Must be called from TIM6_DAC_IRQHandler
+ * @param  None
+ * @retval None
+ */
+void MS5607_TimerIRQHandler(void);
+
 /**
  * @brief  Converts uncompensated values into real world values using data from @ref promData and @ref MS5607UncompensatedValues
  * @note   Must be called after @ref MS5607UncompensatedRead
@@ -179,7 +213,50 @@ void MS5607SetTemperatureOSR(MS5607OSRFactors);
  */
 void MS5607SetPressureOSR(MS5607OSRFactors);
 
+/**
+ * @brief  Sets how often the temperature (D2) is converted
+ * @note   With n > 1 only every n-th cycle converts D2, the others reuse the
+ *         last D2 and complete right after the pressure conversion
+ * @param  Decimation factor, 0 or 1 converts D2 every cycle
+ * @retval None
+ */
+void MS5607SetTemperatureDecimation(uint8_t);
+
+/**
+ * @brief  Gets the datasheet maximum ADC conversion time
+ * @param  OSR factor from 256 to 4096
+ * @retval Conversion time in microseconds
+ */
+uint32_t MS5607ConversionTimeUs(MS5607OSRFactors);
+
 Barometer_2_Axis MS5607_ReadData();
+
+/**
+ * @brief  Collects a completed conversion and starts the next one
+ * @note   Non-blocking: starts a cycle if none is running and returns 0
+ *         until a new sample is available. In continuous mode it pops the
+ *         oldest queued sample instead, in conversion order.
+ * @param  Address of the Barometer_2_Axis structure to fill
+ * @retval 1 if data was updated, 0 otherwise
+ */
+uint8_t MS5607_ReadDataAsync(Barometer_2_Axis *data);
+
+/**
+ * @brief  Converts back to back from the TIM6 interrupt, independently of
+ *         the caller, queuing up to MS5607_SAMPLE_RING_SIZE samples
+ * @note   The blocking reads (MS5607Update, MS5607_ReadData) must not be
+ *         used until MS5607_StopContinuous()
+ * @retval None
+ */
+void MS5607_StartContinuous(void);
+void MS5607_StopContinuous(void);
+
+/**
+ * @brief  Samples lost because the queue was full since the last start
+ * @retval Number of samples
+ */
+uint32_t MS5607_DroppedSamples(void);
+
 void ms5607_print_barometer_data(Barometer_2_Axis *data);
 
 #ifdef __cplusplus
@@ -32,11 +32,23 @@
 #include "stm32l4xx_hal.h"
 
 
+#define SDS_RX_BUFFER_SIZE  64	// Circular DMA buffer, a bit over 6 frames
+#define SDS_FRAME_LENGTH    10	// AA C0 PM25L PM25H PM10L PM10H ID1 ID2 CHK AB
+
+
 typedef struct SDS_t {
   UART_HandleTypeDef* huart_sds;
-  uint16_t pm_2_5;
-  uint16_t  pm_10;
-  uint8_t data_receive[19];
+  uint16_t pm_2_5;			// 0.1 ug/m3
+  uint16_t  pm_10;			// 0.1 ug/m3
+  volatile uint32_t sequence;	// Even: pm values stable, odd: being updated. Advances by 2 per frame
+  uint8_t rx_buffer[SDS_RX_BUFFER_SIZE];
+  uint16_t rx_tail;			// Next ring position for the parser
+  uint8_t frame[SDS_FRAME_LENGTH];
+  uint8_t frame_len;
+  uint32_t frames_ok;
+  uint32_t checksum_errors;
+  uint32_t resyncs;			// Bytes skipped while hunting for a header
+  uint32_t rx_restarts;
 } SDS;
 
 
@@ -86,12 +98,14 @@ static const uint8_t Sds011_WorkingMode[] = {
 
 
 int8_t sdsInit(SDS* sds, const UART_HandleTypeDef* huart_sds);
-void sds_uart_RxCpltCallback(SDS* sds, UART_HandleTypeDef *huart);
+void sds_uart_RxEventCallback(SDS* sds, UART_HandleTypeDef *huart, uint16_t pos);
+void sds_uart_ErrorCallback(SDS* sds, UART_HandleTypeDef *huart);
 
 int8_t sdsSend(SDS* sds, const uint8_t *data_buffer, const uint8_t length);
 
 uint16_t sdsGetPm2_5(SDS* sds);
 uint16_t sdsGetPm10(SDS* sds);
+uint32_t sdsRead(SDS* sds, float *pm2_5, float *pm10);
 
 int8_t sdsWorkingMode(SDS* sds);
 int8_t sdsSleepMode(SDS* sds);
@@ -58,7 +58,14 @@ void SysTick_Handler(void);
 void DMA1_Channel1_IRQHandler(void);
 void USART3_IRQHandler(void);
 /* USER CODE BEGIN EFP */
-
+void DMA1_Channel4_IRQHandler(void);
+void DMA1_Channel5_IRQHandler(void);
+void SPI2_IRQHandler(void);
+void TIM6_DAC_IRQHandler(void);
+void TIM2_IRQHandler(void);
+void DMA1_Channel3_IRQHandler(void);
+void I2C3_EV_IRQHandler(void);
+void I2C3_ER_IRQHandler(void);
 /* USER CODE END EFP */
 
 #ifdef __cplusplus
@@ -0,0 +1,26 @@
+/*
+ * altitude.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef INC_TOOLS_H_ALTITUDE_H_
+#define INC_TOOLS_H_ALTITUDE_H_
+
+/* ========================== */
+/*     BAROMETRIC ALTITUDE    */
+/* ========================== */
+
+#define ALTITUDE_SCALE_M      44330.0f   // Barometric formula: h = 44330 * (1 - (p / p0)^0.1903)
+#define ALTITUDE_EXPONENT     0.1903f
+
+/**
+ * Altitude above the reference pressure level, in meters.
+ * Single-precision only (no libm, no double): the power is evaluated as
+ * exp2(0.1903 * log2(p / p0)) with short polynomials. Within 0.05 m of the
+ * double-precision pow() formula from 0 to 40 km (Host/tests/altitude_accuracy.c).
+ */
+float altitude_from_pressure(float pressure, float reference_pressure);
+
+#endif /* INC_TOOLS_H_ALTITUDE_H_ */
@@ -20,6 +20,8 @@
 extern SPI_HandleTypeDef hspi1; // BAROMETER SPI INTERFACE
 extern ADC_HandleTypeDef hadc1;
 
+extern UART_HandleTypeDef huart1; // TELEMETRY DOWNLINK (radio)
+extern UART_HandleTypeDef huart2; // DEBUG CONSOLE (ST-LINK virtual COM port)
 extern UART_HandleTypeDef huart3;
 
 /* ========================== */
@@ -38,6 +40,15 @@ typedef enum {
 /* ========================== */
 
 #define FIRMWARE_VERSION       "Satellite_Atmos v1.0"
+#define SRAM2_NOINIT           __attribute__((section(".sram2")))  // 32 KB SRAM2, not cleared at startup: initialise before use
+
+
+/* ========================== */
+/*        TIMEBASE SETTINGS   */
+/* ========================== */
+
+//#define TIMEBASE_LSE_DISCIPLINE        // Lock the MSI to a 32.768 kHz crystal on OSC32 (needs the LSE fitted)
+#define TIMEBASE_LSE_TIMEOUT_MS  2000    // LSE start-up budget before falling back to the bare MSI
 
 
 /*         DEBUG SETTINGS     */
@@ -48,6 +59,17 @@ typedef enum {
 //#define STORAGE_LOGS             // Store Logs on the external SD Card
 //#define STORAGE_TELEMETRY        // Store Telemetry on the external SD Card
 #define LOG_BUFFER_SIZE        256
+#define EVENT_LOG_TOKENIZED      // Events as binary token records in eventsNNN.bin (Tools/decode_events.py). Comment out for the logsNNN.csv text log
+#define EVENT_LOG_ITM_PORT     1        // SWV stimulus port of the token records (printf uses port 0)
+#if !defined(CONSOLE_BACKEND_ITM) && !defined(CONSOLE_BACKEND_UART)   // May come from the command line (host build)
+#define CONSOLE_BACKEND_ITM      // printf/log_print drain to SWV stimulus port 0 in the background (tools_h/console.h)
+//#define CONSOLE_BACKEND_UART     // ... or to USART2 (ST-LINK virtual COM port, 115200 8N1) by TX DMA. Define one at most
+#endif
+#define CONSOLE_BUFFER_SIZE    2048     // Queued console text (power of two); a write that does not fit is dropped and counted
+#define CONSOLE_EVENT_BUFFER_SIZE 1024  // Queued token records for EVENT_LOG_ITM_PORT (power of two)
+#define CONSOLE_ITM_BURST      64       // Most bytes handed to the ITM per console_service() call
+#define PROFILER                 // Flight loop stage timing (DWT), dumped at phase transitions. Comment out to compile it out
+#define PROFILER_HIST_BUCKETS  28       // log2 latency buckets per stage (2^27 cycles = 1.7 s at 80 MHz)
 
 
 
@@ -97,6 +119,12 @@ typedef enum {
 #define APOGEE_COUNT_THRESHOLD     5
 
 #define NUM_SAMPLES 100  // Number of readings to average
+
+// MS5607 sampling (conversion time 0.60 / 1.17 / 2.28 / 4.54 / 9.04 ms for OSR 256 ... 4096)
+#define MS5607_PRESSURE_OSR          OSR_4096
+#define MS5607_TEMPERATURE_OSR       OSR_4096
+#define MS5607_TEMPERATURE_DECIMATION 8      // Convert temperature every N pressure samples
+#define MS5607_SAMPLE_RING_SIZE      32     // Queued samples in continuous mode (power of two): ~300 ms of SD latency at OSR 4096
 #define P0  1013.25     // Pressure at sea level
 #define SEA_LEVEL_PRESSURE 102450.0  // Sea level standard atmospheric pressure in Pa
 #define GAS_CONSTANT 8.31432         // Universal gas constant in N·m/(mol·K)
@@ -109,18 +137,91 @@ typedef enum {
 
 
 
+/* Flight loop scheduler */
+// The barometer is polled on every pass; the slow sensors are read when due, at the periods of the rate profile
+#define SCHEDULER_MAX_TASKS        8
+#define SCHED_SDS011_DEADLINE_MS   500
+#define SCHED_ENS160_DEADLINE_MS   250
+#define SCHED_AHT21_DEADLINE_MS    500
+#define SCHED_AHT21_OFFSET_MS      125   // Phase against the ENS160 reads on the shared I2C3
+#define SCHED_MICS5524_DEADLINE_MS 100
+
+/* Phase rate profiles (tools_h/rate_profile.h) */
+// Per phase: slow sensor periods (ms), telemetry records to the card (1 per N barometer samples) and the
+// downlink floor (at least N samples per frame, the link budget may ask for more). The barometer always
+// converts at full rate: it paces the loop and feeds the pre-trigger recorder.
+//   SDS011 reports once per second; ENS160 has a 1 Hz data rate (a poll reads DATA_STATUS only until NEWDAT);
+//   an AHT21 run collects the previous measurement and triggers the next (>= AHT21_MEASUREMENT_MS);
+//   MICS5524 output is 10 Hz after decimation
+//      phase          sds011 ens160 aht21 mics5524  sd  downlink
+#define RATE_PROFILE_TABLE(X) \
+    X(PREFLIGHT,       1000,  1000,  5000,  1000,  100,  100) \
+    X(ASCENT,          1000,   250,  1000,   100,    1,    1) \
+    X(APOGEE,          1000,   250,   250,   100,    1,    1) \
+    X(DESCENT,         1000,   250,  1000,   100,    2,    2) \
+    X(POSTFLIGHT,      1000,  1000,  5000,  1000,   10,   20)
+#define RATE_APOGEE_SPEED_MPS      3.0f  // |vertical speed| below this switches to the APOGEE burst profile (left above 1.5x)
+#define RATE_APOGEE_MIN_MS         2000  // The burst lasts at least this long, even through a sharp turnaround
+#define RATE_SPEED_WINDOW_MS       250   // Vertical speed from the smoothed altitude over this sliding interval, updated every sample
+#define RATE_SPEED_SLOTS           8     // Altitude checkpoints held across the window
+#define POSTFLIGHT_LOG_MS          10000 // Keep recording this long after touchdown, with the POSTFLIGHT profile
+
+/* Pre-trigger recorder */
+#define PRETRIGGER                         // Keep the samples before takeoff detection in SRAM2 and write them ahead of the flight telemetry (tools_h/pretrigger.h)
+#define PRETRIGGER_RECORDS         400     // Samples held: 400 x 54 B = 21.6 KB of SRAM2, ~3.6 s at the OSR 4096 barometer rate
+#define PRETRIGGER_SECONDS         3       // Written at takeoff: this much before the detection (launch transient + climb to the threshold)
+#define PRETRIGGER_FLUSH_BATCH     8       // Samples written per flight loop pass while the recorder drains (1 is pass-through)
+#define PREFLIGHT_LOG_DECIMATION   100     // Pre-flight barometer events on the card: one per this many samples (~1 s)
+
+
+
 /* MICS5524 Gas Sensor */
 
 // === MICS5524 Sensor Configuration ===
 #define MICS5524_VREF         5.0f  // Tension de référence ADC (en V)
 #define MICS5524_ADC_HANDLE   hadc1 // ADC utilisé (défini dans ton main.c)
+#define MICS5524_SUPPLY       5.0f  // Heater/divider supply Vc (V), for Rs/RL = (Vc - Vout) / Vout
+
+// Acquisition: TIM15-triggered ADC1 IN3, hardware oversampling, DMA double buffer
+#define MICS5524_TRIGGER_HZ          1000                       // ADC trigger rate (TIM15 TRGO)
+#define MICS5524_OVERSAMPLING_RATIO  ADC_OVERSAMPLING_RATIO_16  // Conversions accumulated per trigger
+#define MICS5524_OVERSAMPLING_SHIFT  ADC_RIGHTBITSHIFT_2        // 16x sum >> 2 ...
+#define MICS5524_RESULT_BITS         14                         // ... = 14-bit result (12 + log2(ratio) - shift)
+#define MICS5524_DECIMATION          100                        // Triggers averaged per output: 10 Hz
+#define MICS5524_BASELINE_OUTPUTS    50                         // Outputs averaged into R0 (clean air at start)
 
 
 /* SD CARD */
+// SPI link
+#define SD_SPI_MAX_CLOCK_HZ    20000000          // Board limit for the SD card SPI clock (card limit comes from its CSD)
+#define SD_SPI_READ_CRC_CHECK                    // Verify the CRC16 of every sector read, step the clock down on mismatch
+#define SD_SPI_WRITE_STREAMING                   // Keep CMD25 open across sequential sector writes
+
 // File status and config
-#define LOG_BURST_N         32
-#define TELEMETRY_BURST_N   32
+#define BB_STREAM_BUFFER_SIZE  1024              // Bytes per ping-pong buffer, multiple of 512 (two per open file)
+#define BB_SYNC_INTERVAL_MS    2000              // Flush partial buffers and f_sync at least this often
+#define BB_SYNC_BYTES          (16 * 1024)       // ... or after this many bytes were written
+#define TELEMETRY_PREALLOC_SIZE (8UL * 1024 * 1024) // Contiguous space reserved for the telemetry file (0: grow on demand)
 #define LOG_FILE_NAME       "logs.csv"
 #define TELEMETRY_FILE_NAME "telemetry.csv"
 
+// Telemetry storage formats (both can be enabled at the same time)
+#define TELEMETRY_FORMAT_BINARY  // Packed CRC-protected records in telemetryNNN.bin (see tools_h/telemetry.h)
+//#define TELEMETRY_FORMAT_CSV     // Human-readable rows in telemetryNNN.csv (slow: snprintf of every float)
+#define TELEMETRY_COMPRESSION      // Keyframe + zigzag-varint delta records in telemetryNNN.bin (see tools_h/telemetry_codec.h)
+#define TELEMETRY_KEYFRAME_INTERVAL 100 // Records per keyframe: a damaged record loses at most this many (~1 s)
+
+// Event log compression
+#define EVENT_LOG_COMPRESSION      // LZ-compress the event log on the card: eventsNNN.lz / logsNNN.lz (tools_h/lz_stream.h, Tools/lz_decompress.py)
+#define LZ_MAX_CHAIN           16  // Earlier occurrences tried per position by the compressor (CPU time vs ratio)
+
+
+/* TELEMETRY DOWNLINK */
+#define DOWNLINK                          // Live COBS telemetry frames on DOWNLINK_UART (tools_h/downlink.h). Comment out to compile it out
+#define DOWNLINK_UART            huart1   // USART1 (PA9 TX, 115200 8N1); its TX DMA (DMA2 channel 6) is set up in HAL_UART_MspInit
+#define DOWNLINK_LINK_BPS        57600    // Bit rate the radio sustains over the air (<= the UART baud rate)
+#define DOWNLINK_BUDGET_PERCENT  80       // Share of the link the frames may use; samples are decimated to stay within it
+#define DOWNLINK_QUEUE_SIZE      1024     // Bytes of queued frames (power of two): ~27 frames
+#define DOWNLINK_MAX_DECIMATION  50       // Never fewer frames than one per this many samples
+
 #endif /* INC_CONFIGURATION_H_ */
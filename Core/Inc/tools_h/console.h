@@ -0,0 +1,62 @@
+/*
+ * console.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef INC_TOOLS_H_CONSOLE_H_
+#define INC_TOOLS_H_CONSOLE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stm32l4xx_hal.h"
+
+/* ========================== */
+/*      BUFFERED CONSOLE      */
+/* ========================== */
+
+/*
+ * printf (through _write) and log_print only copy their text into a RAM
+ * ring; it drains in the background, so debug output costs the same
+ * whether or not anyone is listening. A write that does not fit is
+ * dropped whole and counted, never waited for.
+ *
+ * CONSOLE_BACKEND_ITM: console_service() hands the stimulus ports what
+ * their FIFOs take without spinning, at most CONSOLE_ITM_BURST bytes per
+ * call. With no debugger attached (ITM disabled) writes are discarded.
+ *
+ * CONSOLE_BACKEND_UART: the text goes out of USART2 (ST-LINK virtual COM
+ * port) by TX DMA, one contiguous run of the ring at a time, each
+ * transfer complete interrupt starting the next.
+ *
+ * Token records of the event log use their own channel, sent on ITM port
+ * EVENT_LOG_ITM_PORT; the UART backend carries text only.
+ */
+
+typedef enum {
+    CONSOLE_CHANNEL_TEXT = 0,   // printf and log_print: ITM port 0 or USART2
+    CONSOLE_CHANNEL_EVENTS,     // Binary event records: ITM port EVENT_LOG_ITM_PORT
+    CONSOLE_CHANNEL_COUNT
+} ConsoleChannel;
+
+/**
+ * Queue len bytes from thread context. Returns false if they were dropped
+ * (ring full); true when queued or when the backend has no listener.
+ */
+bool console_write(ConsoleChannel channel, const void *data, uint32_t len);
+
+/**
+ * Moves queued bytes towards the backend without blocking. Call it from
+ * the main loops; the UART backend also restarts itself from its interrupt.
+ */
+void console_service(void);
+
+/* Bytes dropped on full rings since boot, all channels */
+uint32_t console_dropped(void);
+
+/* Called from HAL_UART_TxCpltCallback / HAL_UART_ErrorCallback */
+void console_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void console_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+#endif /* INC_TOOLS_H_CONSOLE_H_ */
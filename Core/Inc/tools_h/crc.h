@@ -0,0 +1,33 @@
+/*
+ * crc.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef INC_TOOLS_H_CRC_H_
+#define INC_TOOLS_H_CRC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ========================== */
+/*        CRC FUNCTIONS       */
+/* ========================== */
+
+#define CRC16_CCITT_INIT 0xFFFF
+
+/**
+ * CRC-16/CCITT (poly 0x1021, MSB first, no reflection, no final XOR).
+ * Pass CRC16_CCITT_INIT as crc for a fresh computation, or the previous
+ * result to continue over several buffers.
+ */
+uint16_t crc16_ccitt(const void *data, size_t len, uint16_t crc);
+
+/**
+ * CRC-8 (poly 0x07, init 0x00, MSB first, no final XOR), for short records
+ * where two CRC bytes would be a large share of the size.
+ */
+uint8_t crc8(const void *data, size_t len);
+
+#endif /* INC_TOOLS_H_CRC_H_ */
@@ -0,0 +1,90 @@
+/*
+ * downlink.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef INC_TOOLS_H_DOWNLINK_H_
+#define INC_TOOLS_H_DOWNLINK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stm32l4xx_hal.h"
+#include "tools_h/telemetry.h"
+
+/* ========================== */
+/*     TELEMETRY DOWNLINK     */
+/* ========================== */
+
+/*
+ * Live telemetry for the ground station on a spare UART (DOWNLINK_UART)
+ * by TX DMA: the flight loop only packs and queues a frame, so the SD path
+ * is never held up by the radio.
+ *
+ * Frame: downlink_telemetry_frame_t (fixed-point, little-endian) with a
+ * CRC-16/CCITT over the preceding bytes, COBS-encoded and terminated by a
+ * 0x00 byte, so a receiver resynchronises on the next zero after any
+ * corruption or dropout.
+ *
+ * Samples are decimated to keep the frame rate within DOWNLINK_BUDGET_PERCENT
+ * of DOWNLINK_LINK_BPS, from the measured interval between samples: one
+ * frame every `decimation` samples, carried in the frame. A frame that does
+ * not fit in the queue is dropped and counted.
+ * Tools/downlink_rx.py decodes the stream from a serial port, pty or capture.
+ */
+
+#define DOWNLINK_FRAME_TELEMETRY   0x01
+#define DOWNLINK_WIRE_MAX          (sizeof(downlink_telemetry_frame_t) + 2)   // COBS code byte + delimiter
+
+typedef struct __attribute__((packed)) {
+    uint8_t  type;              // DOWNLINK_FRAME_TELEMETRY
+    uint8_t  decimation;        // Samples represented by this frame
+    uint16_t seq;               // Frames queued so far, wraps: gaps are lost frames
+    uint32_t time_ms;           // timestamp_us / 1000
+    uint32_t pressure_dpa;      // 0.1 Pa
+    int16_t  temperature_cdeg;  // 0.01 degC
+    int32_t  altitude_cm;
+    uint16_t pm2_5_dug;         // 0.1 ug/m3
+    uint16_t pm10_dug;
+    uint8_t  aqi;
+    uint16_t tvoc_ppb;
+    uint16_t eco2_ppm;
+    int16_t  aht21_temperature_cdeg;
+    uint16_t aht21_humidity_cpct; // 0.01 %RH
+    uint16_t mics5524_mv;
+    uint16_t crc;
+} downlink_telemetry_frame_t;
+
+_Static_assert(sizeof(downlink_telemetry_frame_t) == 35, "downlink frame layout changed");
+
+typedef struct {
+    uint32_t frames_sent;       // Queued for the UART
+    uint32_t frames_dropped;    // Queue full
+    uint32_t decimation;        // Current samples per frame
+} DownlinkStats;
+
+/**
+ * Binds the downlink to a UART whose TX DMA is set up in its MspInit.
+ */
+void downlink_init(UART_HandleTypeDef *huart);
+
+/**
+ * Offers one telemetry sample from thread context; its crc is not used.
+ * Returns true if a frame was queued.
+ */
+bool downlink_telemetry(const telemetry_record_t *sample);
+
+/**
+ * Never fewer than n samples per frame, whatever the link budget allows
+ * (phase rate profiles). Capped at 255, the range of the frame's field.
+ */
+void downlink_set_min_decimation(uint32_t n);
+
+void downlink_get_stats(DownlinkStats *stats);
+
+/* Called from HAL_UART_TxCpltCallback / HAL_UART_ErrorCallback */
+void downlink_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void downlink_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+#endif /* INC_TOOLS_H_DOWNLINK_H_ */
@@ -0,0 +1,62 @@
+/*
+ * event_log.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef INC_TOOLS_H_EVENT_LOG_H_
+#define INC_TOOLS_H_EVENT_LOG_H_
+
+#include <stdint.h>
+#include "tools_h/log_tokens.h"
+
+/* ========================== */
+/*    TOKENIZED EVENT LOG     */
+/* ========================== */
+
+/*
+ * With EVENT_LOG_TOKENIZED an event is a token id, a timestamp and the raw
+ * argument bytes: no formatting on the MCU. Records go to eventsNNN.bin
+ * (one event_log_header_t, then records back to back) and, with SWV_DEBUG,
+ * through the console's event channel to ITM stimulus port
+ * EVENT_LOG_ITM_PORT without the file header.
+ *
+ * Record: uint8_t length of the arguments, uint16_t token, uint32_t low
+ * word of timebase_us(), then the arguments packed as per the token's
+ * signature in log_tokens.h, then a CRC-8 (crc8()) over all of it.
+ * Everything is little-endian. When the upper word of the timebase changes
+ * an EVT_TIME_HIGH record carrying it is written first.
+ * Tools/decode_events.py rebuilds the logs.csv layout; after a lost buffer
+ * or a damaged length byte it slides byte by byte to the next record whose
+ * CRC checks out.
+ *
+ * Without EVENT_LOG_TOKENIZED the same calls are formatted on the MCU and
+ * written as text lines through log_event().
+ */
+
+#define EVENT_LOG_MAGIC          0x56454D41u  // "AMEV" once written little-endian
+#define EVENT_LOG_VERSION        2       // 1: records without the CRC-8
+#define EVENT_LOG_RECORD_HEADER  7
+#define EVENT_LOG_RECORD_MAX     (EVENT_LOG_RECORD_HEADER + 255 + 1)
+#define EVENT_LOG_STRING_MAX     200
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    uint16_t token_count;   // LOG_TOKEN_COUNT of the firmware that wrote the file
+    char     firmware[24];
+    uint16_t crc;           // CRC-16/CCITT over the preceding bytes
+} event_log_header_t;
+
+_Static_assert(sizeof(event_log_header_t) == 36, "event log header layout changed");
+
+/**
+ * Log one event from thread context (not from interrupt handlers).
+ * Arguments must match the token's signature: int, unsigned, double or
+ * const char *. Example: event_log(EVT_APOGEE, altitude);
+ */
+void event_log(log_token_t token, ...);
+
+#endif /* INC_TOOLS_H_EVENT_LOG_H_ */
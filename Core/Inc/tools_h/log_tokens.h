@@ -0,0 +1,66 @@
+/*
+ * log_tokens.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef INC_TOOLS_H_LOG_TOKENS_H_
+#define INC_TOOLS_H_LOG_TOKENS_H_
+
+/* ========================== */
+/*     EVENT LOG DICTIONARY   */
+/* ========================== */
+
+/*
+ * Every tokenized event, once: X(id, name, level, args, format).
+ *   id      on-disk token, never reuse or renumber one (old files decode with it)
+ *   args    one character per argument, in order:
+ *             f  float/double, stored as float32
+ *             i  int, stored as int32
+ *             u  unsigned, stored as uint32
+ *             s  const char *, stored length-prefixed (EVENT_LOG_STRING_MAX)
+ *   format  printf format, expanded on the host by Tools/decode_events.py
+ *
+ * The firmware keeps only the ids and the argument signatures;
+ * Tools/log_dictionary.py extracts this table for the decoder.
+ */
+#define LOG_TOKEN_TABLE(X) \
+    X(0x00, TIME_HIGH,            "INFO",      "u",   "Timebase upper word %u") \
+    X(0x01, TEXT,                 "",          "ss",  "%s") \
+    X(0x02, SD_MOUNT_FAILED,      "ERROR",     "",    "SD card mount failed") \
+    X(0x03, SD_READY,             "INFO",      "",    "SD card mounted and log/telemetry ready") \
+    X(0x04, SENSOR_INIT_FAILED,   "ERROR",     "s",   "%s initialization failed") \
+    X(0x05, SENSOR_INIT_OK,       "INFO",      "s",   "%s initialized") \
+    X(0x06, INIT_COMPLETE,        "INFO",      "",    "System init complete. Ready for pre-flight.") \
+    X(0x07, WAITING_TAKEOFF,      "STATE",     "",    "Waiting for Takeoff Detection...") \
+    X(0x08, BARO_SAMPLE,          "BAROMETER", "fff", "[BAROMETER] Pressure: %.3f Pa, Temp: %.3f degC, Altitude: %.3f meters") \
+    X(0x09, TAKEOFF,              "STATE",     "",    "TAKEOFF DETECTED!") \
+    X(0x0A, TO_FLIGHT,            "STATE",     "",    "Transition to Flight Mode") \
+    X(0x0B, PREFLIGHT_INTERRUPTED,"STATE",     "",    "Interrupted - Exiting Pre-Flight") \
+    X(0x0C, FLIGHT_ENTERED,       "STATE",     "",    "Entered FLIGHT PHASE") \
+    X(0x0D, APOGEE,               "EVENT",     "f",   "APOGEE detected at %.2f meters!") \
+    X(0x0E, TOUCHDOWN,            "EVENT",     "f",   "TOUCHDOWN detected at %.2f m") \
+    X(0x0F, BARO_DROPPED,         "INFO",      "u",   "Barometer samples dropped: %u") \
+    X(0x10, POSTFLIGHT_ENTERED,   "STATE",     "",    "Entered POST-FLIGHT PHASE") \
+    X(0x11, SD_FLUSHED,           "INFO",      "",    "SD files flushed and closed.") \
+    X(0x12, WELCOME,              "INFO",      "",    "Sat Atmo - Diamant A Experience - Welcome!") \
+    X(0x13, CONSOLE_DROPPED,      "INFO",      "u",   "Console bytes dropped: %u") \
+    X(0x14, DOWNLINK_STATS,       "INFO",      "uuu", "Downlink: %u frames sent, %u dropped, 1 frame per %u samples") \
+    X(0x15, PRETRIGGER_FLUSH,     "INFO",      "uu",  "Pre-trigger: %u samples from the last %u ms before takeoff queued for the card") \
+    X(0x16, PRETRIGGER_OVERRUNS,  "INFO",      "u",   "Pre-trigger samples overwritten before reaching the card: %u") \
+    X(0x17, RATE_PROFILE,         "INFO",      "sf",  "Rate profile %s (vertical speed %.1f m/s)")
+
+#define LOG_TOKEN_LIMIT  64     // Highest id + 1 the firmware tables can hold
+
+#define LOG_TOKEN_ENUM(id, name, level, args, format) EVT_##name = id,
+typedef enum {
+    LOG_TOKEN_TABLE(LOG_TOKEN_ENUM)
+} log_token_t;
+#undef LOG_TOKEN_ENUM
+
+#define LOG_TOKEN_ONE(id, name, level, args, format) + 1
+enum { LOG_TOKEN_COUNT = 0 LOG_TOKEN_TABLE(LOG_TOKEN_ONE) };
+#undef LOG_TOKEN_ONE
+
+#endif /* INC_TOOLS_H_LOG_TOKENS_H_ */
@@ -13,6 +13,7 @@
 #include <stdarg.h>
 #include "stm32l4xx_hal.h"
 #include "configuration.h"
+#include "tools_h/console.h"
 
 /* ========================== */
 /*        LOGGER FUNCTION     */
@@ -23,11 +24,14 @@ static inline void log_print(const char *format, ...) {
     char buffer[LOG_BUFFER_SIZE];
     va_list args;
     va_start(args, format);
-    vsnprintf(buffer, LOG_BUFFER_SIZE, format, args);
+    int len = vsnprintf(buffer, LOG_BUFFER_SIZE, format, args);
     va_end(args);
 
 #ifdef SWV_DEBUG
-    printf("%s", buffer); // SWV output
+    if (len > 0) {
+        if (len >= LOG_BUFFER_SIZE) len = LOG_BUFFER_SIZE - 1;
+        console_write(CONSOLE_CHANNEL_TEXT, buffer, (uint32_t)len); // Buffered SWV/UART output, never blocks
+    }
 #endif
 
 #endif // LOGGER
@@ -0,0 +1,90 @@
+/*
+ * lz_stream.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef INC_TOOLS_H_LZ_STREAM_H_
+#define INC_TOOLS_H_LZ_STREAM_H_
+
+#include <stdint.h>
+
+/* ========================== */
+/*   STREAMING LZ COMPRESSOR  */
+/* ========================== */
+
+/*
+ * LZSS over a LZ_WINDOW_SIZE sliding window, fixed RAM, no allocation.
+ * The output is a sequence of groups: a flag byte, then up to 8 items,
+ * one per flag bit starting at bit 0:
+ *   bit clear  literal: one byte
+ *   bit set    match:   uint8_t offset low bits,
+ *                       uint8_t offset bits 8-10 | (length - LZ_MIN_MATCH) << 3
+ *                       copy length bytes from offset bytes back
+ * A match with offset 0 is a sync marker: the group ends there and the
+ * next byte is a flag byte. lz_stream_flush() writes one, so everything
+ * written so far can be decoded from the flushed bytes alone; the history
+ * is kept, so matches still reach back across it.
+ *
+ * A .lz file is one lz_file_header_t then the compressed bytes of the file
+ * it stands for (header included). Tools/lz_decompress.py restores it.
+ * When the file is reopened after a write failure, a new lz_file_header_t
+ * starts a new stream with an empty history; the decompressor restarts
+ * there whether or not the old stream ended cleanly.
+ */
+
+#define LZ_FILE_MAGIC     0x5A4C4D41u  // "AMLZ" once written little-endian
+#define LZ_FILE_VERSION   1
+#define LZ_WINDOW_BITS    11
+#define LZ_WINDOW_SIZE    (1u << LZ_WINDOW_BITS)
+#define LZ_MIN_MATCH      3
+#define LZ_MAX_MATCH      (LZ_MIN_MATCH + 31)
+#define LZ_MAX_OFFSET     (LZ_WINDOW_SIZE - LZ_MAX_MATCH - 1)  // The lookahead shares the window
+#define LZ_HASH_BITS      10
+#define LZ_GROUP_MAX      (1 + 8 * 2)
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t window_size;
+} lz_file_header_t;
+
+_Static_assert(sizeof(lz_file_header_t) == 8, "lz header layout changed");
+
+typedef void (*lz_sink_t)(void *ctx, const uint8_t *data, uint32_t len);
+
+typedef struct {
+    uint8_t  window[LZ_WINDOW_SIZE];
+    uint16_t head[1u << LZ_HASH_BITS];      // Latest position of each 3-byte hash
+    uint16_t prev[LZ_WINDOW_SIZE];          // Previous position with the same hash
+    uint32_t total;                         // Bytes taken in
+    uint32_t cursor;                        // Bytes encoded; total - cursor is the lookahead
+    uint32_t hashed;                        // Positions entered into the chains
+    uint8_t  group[LZ_GROUP_MAX];
+    uint32_t group_len;
+    uint32_t group_items;
+    lz_sink_t sink;
+    void    *ctx;
+    uint32_t bytes_in;
+    uint32_t bytes_out;
+} lz_stream_t;
+
+/**
+ * Start an empty stream; compressed bytes go to sink(ctx, ...) one group
+ * at a time. The state is about 8 KB: place it in SRAM2_NOINIT memory.
+ */
+void lz_stream_init(lz_stream_t *lz, lz_sink_t sink, void *ctx);
+
+/**
+ * Compress len bytes. Up to LZ_MAX_MATCH of them are held back as
+ * lookahead until more data or a flush.
+ */
+void lz_stream_write(lz_stream_t *lz, const void *data, uint32_t len);
+
+/**
+ * Encode the lookahead and end the current group with a sync marker.
+ */
+void lz_stream_flush(lz_stream_t *lz);
+
+#endif /* INC_TOOLS_H_LZ_STREAM_H_ */
@@ -0,0 +1,64 @@
+/*
+ * pretrigger.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef INC_TOOLS_H_PRETRIGGER_H_
+#define INC_TOOLS_H_PRETRIGGER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tools_h/telemetry.h"
+
+/* ========================== */
+/*   PRE-TRIGGER RECORDER     */
+/* ========================== */
+
+/*
+ * Full-rate telemetry samples in a circular buffer of PRETRIGGER_RECORDS
+ * in SRAM2. On the pad the newest sample overwrites the oldest, so the
+ * buffer always holds the last few seconds. At takeoff
+ * pretrigger_trigger() keeps the last PRETRIGGER_SECONDS of them, and the
+ * flight loop keeps pushing live samples and pops a few per pass: the
+ * launch transient reaches the card first, in time order, and the buffer
+ * then drains down to pass-through. Main loop only, no interrupt access.
+ */
+
+/**
+ * Empty the buffer (SRAM2 is not cleared at startup).
+ */
+void pretrigger_init(void);
+
+/**
+ * Append a sample, overwriting the oldest one when full. Before the
+ * trigger the overwritten sample is copied to evicted (the pad trickle to
+ * the card); overwrites after the trigger are counted, those samples never
+ * reach the card.
+ * @return true when a pre-trigger sample was evicted into *evicted.
+ */
+bool pretrigger_push(const telemetry_record_t *sample, telemetry_record_t *evicted);
+
+/**
+ * Takeoff: drop samples older than PRETRIGGER_SECONDS before now_us.
+ * @return Number of samples kept.
+ */
+uint32_t pretrigger_trigger(uint64_t now_us);
+
+/**
+ * Timestamp of the oldest buffered sample, 0 when empty.
+ */
+uint64_t pretrigger_oldest_us(void);
+
+/**
+ * Take the oldest sample. Returns false when empty.
+ */
+bool pretrigger_pop(telemetry_record_t *sample);
+
+/**
+ * Samples overwritten before they were popped since the trigger.
+ */
+uint32_t pretrigger_overruns(void);
+
+#endif /* INC_TOOLS_H_PRETRIGGER_H_ */
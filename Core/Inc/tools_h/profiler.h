@@ -0,0 +1,64 @@
+/*
+ * profiler.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef INC_TOOLS_H_PROFILER_H_
+#define INC_TOOLS_H_PROFILER_H_
+
+#include <stdint.h>
+#include "stm32l4xx_hal.h"
+#include "configuration.h"
+
+/* ========================== */
+/*     FLIGHT LOOP PROFILER   */
+/* ========================== */
+
+/*
+ * Stage timing on the DWT cycle counter. PROF_START/PROF_END bracket a
+ * stage inside one block. Per stage the profiler keeps count, min, max,
+ * mean and a log2 histogram (bucket k: 2^(k-1) <= cycles < 2^k).
+ * profiler_dump() writes the table to SWV and the log file, then starts
+ * over. Without PROFILER in configuration.h everything compiles to nothing.
+ */
+
+typedef enum {
+    PROF_STAGE_LOOP,          // Whole flight loop iteration
+    PROF_STAGE_BAROMETER,
+    PROF_STAGE_SDS011,
+    PROF_STAGE_ENS160,
+    PROF_STAGE_AHT21,
+    PROF_STAGE_MICS5524,
+    PROF_STAGE_TELEMETRY,
+    PROF_STAGE_DOWNLINK,
+    PROF_STAGE_SD_SERVICE,
+    PROF_STAGE_COUNT
+} ProfilerStage;
+
+#ifdef PROFILER
+
+void profiler_init(void);
+void profiler_record(ProfilerStage stage, uint32_t cycles);
+void profiler_dump(const char *phase);
+void profiler_reset(void);
+
+static inline uint32_t profiler_cycles(void) {
+    return DWT->CYCCNT;
+}
+
+#define PROF_START(stage)  const uint32_t prof_start_##stage = profiler_cycles()
+#define PROF_END(stage)    profiler_record((stage), profiler_cycles() - prof_start_##stage)
+
+#else
+
+#define profiler_init()          ((void)0)
+#define profiler_dump(phase)     ((void)0)
+#define profiler_reset()         ((void)0)
+#define PROF_START(stage)        ((void)0)
+#define PROF_END(stage)          ((void)0)
+
+#endif /* PROFILER */
+
+#endif /* INC_TOOLS_H_PROFILER_H_ */
@@ -0,0 +1,79 @@
+/*
+ * rate_profile.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef INC_TOOLS_H_RATE_PROFILE_H_
+#define INC_TOOLS_H_RATE_PROFILE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tools_h/configuration.h"
+
+/* ========================== */
+/*    PHASE RATE PROFILES     */
+/* ========================== */
+
+/*
+ * One row of RATE_PROFILE_TABLE (configuration.h) per flight phase: how
+ * often each slow sensor is read and how much of the barometer rate goes
+ * to the card and to the downlink. The manager switches rows on state
+ * transitions, and in flight on the vertical speed: ASCENT while climbing,
+ * APOGEE while the speed is near zero, DESCENT once falling after apogee.
+ * A causal speed estimate lags the apex by some tens of milliseconds, so on
+ * a sharp turnaround the burst starts just after it; RATE_APOGEE_MIN_MS
+ * keeps it going through the first seconds of the descent.
+ */
+
+#define RATE_PROFILE_ENUM(name, sds011, ens160, aht21, mics5524, sd, downlink) RATE_PROFILE_##name,
+typedef enum {
+    RATE_PROFILE_TABLE(RATE_PROFILE_ENUM)
+    RATE_PROFILE_COUNT
+} RateProfileId;
+#undef RATE_PROFILE_ENUM
+
+typedef struct {
+    const char *name;
+    uint16_t sds011_period_ms;
+    uint16_t ens160_period_ms;
+    uint16_t aht21_period_ms;
+    uint16_t mics5524_period_ms;
+    uint16_t sd_decimation;         // Telemetry records to the card: one per this many barometer samples
+    uint16_t downlink_decimation;   // At least this many samples per downlink frame
+} RateProfile;
+
+typedef struct {
+    float    altitude;                          // Smoothed altitude (m)
+    float    slot_altitude[RATE_SPEED_SLOTS];   // Checkpoints of the smoothed altitude, one per window/slots
+    uint64_t slot_us[RATE_SPEED_SLOTS];
+    uint8_t  newest;
+    uint8_t  count;
+    float    speed;                             // m/s, positive up
+} VerticalSpeed;
+
+const RateProfile *rate_profile(RateProfileId id);
+
+/**
+ * In-flight profile for the current vertical speed, with hysteresis
+ * around RATE_APOGEE_SPEED_MPS. APOGEE is never skipped, is held for at
+ * least RATE_APOGEE_MIN_MS (in_profile_ms: time since the last switch) and
+ * is only left for DESCENT once apogee_detected; DESCENT is final.
+ */
+RateProfileId rate_profile_select(RateProfileId current, float vertical_speed, bool apogee_detected,
+                                  uint32_t in_profile_ms);
+
+void vertical_speed_reset(VerticalSpeed *vs);
+
+/**
+ * Feed one barometer altitude. The altitude is low-pass filtered (1/4 per
+ * sample) and differentiated against the oldest checkpoint of a sliding
+ * RATE_SPEED_WINDOW_MS window, recomputed on every sample. That brings the
+ * ~8 cm per-sample noise of 1 Pa down to about 0.2 m/s with a lag of about
+ * half the window.
+ * @return Latest vertical speed in m/s.
+ */
+float vertical_speed_update(VerticalSpeed *vs, float altitude, uint64_t timestamp_us);
+
+#endif /* INC_TOOLS_H_RATE_PROFILE_H_ */
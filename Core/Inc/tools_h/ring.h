@@ -0,0 +1,63 @@
+/*
+ * ring.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef INC_TOOLS_H_RING_H_
+#define INC_TOOLS_H_RING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ========================== */
+/*     SPSC RING BUFFERS      */
+/* ========================== */
+
+/*
+ * Lock-free queue of fixed-size items between exactly one producer and one
+ * consumer, typically an interrupt handler and the main loop. Nothing is
+ * masked: the producer only writes head, the consumer only writes tail,
+ * and a memory barrier orders the item copy against the index update.
+ *
+ * head and tail run freely and wrap at 2^32; the slot is index & mask,
+ * so the capacity must be a power of two. A full ring refuses the new
+ * item and counts it in dropped, the consumer never loses what is queued.
+ */
+
+typedef struct {
+    uint8_t *storage;
+    uint32_t item_size;
+    uint32_t mask;                  // capacity - 1
+    volatile uint32_t head;         // Items pushed, written by the producer only
+    volatile uint32_t tail;         // Items popped, written by the consumer only
+    volatile uint32_t dropped;      // Pushes refused on a full ring, producer only
+} Ring;
+
+/**
+ * storage must hold capacity * item_size bytes and outlive the ring.
+ * Returns false if capacity is not a power of two.
+ */
+bool ring_init(Ring *ring, void *storage, uint32_t item_size, uint32_t capacity);
+
+/* Producer side */
+bool ring_push(Ring *ring, const void *item);
+
+/* Consumer side */
+bool ring_pop(Ring *ring, void *item);
+
+/* Items waiting; may grow under the consumer and shrink under the producer */
+uint32_t ring_count(const Ring *ring);
+
+/*
+ * Byte streams (item_size 1). A write is queued whole or refused whole,
+ * counting its bytes in dropped, so the reader never gets half a line.
+ * The consumer can hand the contiguous run at the tail to a DMA and
+ * release it once sent; the run stops at the end of the storage.
+ */
+bool ring_write(Ring *ring, const void *data, uint32_t len);
+uint32_t ring_peek(const Ring *ring, const uint8_t **data);
+void ring_release(Ring *ring, uint32_t len);
+
+#endif /* INC_TOOLS_H_RING_H_ */
@@ -0,0 +1,58 @@
+/*
+ * scheduler.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef INC_TOOLS_H_SCHEDULER_H_
+#define INC_TOOLS_H_SCHEDULER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ========================== */
+/*   COOPERATIVE SCHEDULER    */
+/* ========================== */
+
+/*
+ * Run-to-completion tasks released on the microsecond timebase. A task
+ * with period 0 is polled on every pass (the barometer state machine);
+ * the others run when due, in registration order. Release times advance
+ * by the period so there is no drift; a task that starts later than its
+ * deadline counts a miss and is realigned to the current time.
+ */
+
+typedef void (*SchedulerTaskFn)(uint64_t now_us);
+
+/**
+ * Register a task, first released offset_us from now. Offsets keep tasks
+ * that share a bus out of each other's way. Returns the task id, or -1
+ * when the table (SCHEDULER_MAX_TASKS) is full.
+ */
+int scheduler_add(const char *name, SchedulerTaskFn run, uint32_t period_us,
+                  uint32_t deadline_us, uint32_t offset_us);
+
+/**
+ * Change a task's period, e.g. on a rate profile switch. A shorter period
+ * takes effect at once instead of after the current one runs out.
+ */
+void scheduler_set_period(int id, uint32_t period_us);
+
+/**
+ * Run every task that is due, once each. Returns the number of tasks run.
+ */
+uint8_t scheduler_run_due(void);
+
+/**
+ * Drop all tasks and statistics.
+ */
+void scheduler_reset(void);
+
+/**
+ * Per-task run count, deadline misses and worst lateness to SWV and the
+ * log file.
+ */
+void scheduler_dump(const char *phase);
+
+#endif /* INC_TOOLS_H_SCHEDULER_H_ */
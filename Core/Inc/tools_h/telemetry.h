@@ -0,0 +1,78 @@
+/*
+ * telemetry.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef INC_TOOLS_H_TELEMETRY_H_
+#define INC_TOOLS_H_TELEMETRY_H_
+
+#include <stdint.h>
+
+/* ========================== */
+/*   BINARY TELEMETRY FORMAT  */
+/* ========================== */
+
+/*
+ * A telemetryNNN.bin file is one telemetry_bin_header_t followed by
+ * fixed-size telemetry_record_t entries. Everything is little-endian
+ * (native on the Cortex-M4), floats are IEEE-754 binary32 and each CRC is
+ * CRC-16/CCITT over all preceding bytes of the structure.
+ * Tools/decode_telemetry.py converts the file back to CSV.
+ *
+ * With TELEMETRY_COMPRESSION the header carries TELEMETRY_BIN_VERSION_PACKED
+ * and record_size 0: records are variable length (tools_h/telemetry_codec.h)
+ *   uint8_t  body length, bit 7 set on keyframes
+ *   body     keyframe: varint timestamp_us, then every field as a zigzag varint
+ *            delta:    zigzag varint change of the sample interval, uint16_t
+ *                      mask of the fields that changed (bit 0 = first field),
+ *                      then a zigzag varint delta for each of them
+ *   uint8_t  CRC-8 over the length byte and the body
+ * Varints are LEB128 (7 bits per byte, low group first). Fields are stored
+ * as fixed-point integers in the units of TELEMETRY_PACKED_SCALES, in
+ * record order; INT32_MIN stands for NaN. A keyframe opens the file and
+ * comes back every TELEMETRY_KEYFRAME_INTERVAL records, so a damaged record
+ * loses the data up to the next keyframe only.
+ */
+
+#define TELEMETRY_BIN_MAGIC        0x534D5441u  // "ATMS" once written little-endian
+#define TELEMETRY_BIN_VERSION      3          // 3: + mics5524_voltage, 2: microsecond timestamps (1: uint32_t milliseconds)
+#define TELEMETRY_BIN_VERSION_PACKED 4        // Delta/varint records of TELEMETRY_COMPRESSION
+#define TELEMETRY_FIELD_COUNT      11
+
+// Fixed-point units of the packed fields: 0.01 degC, 0.1 Pa, cm, 0.1 ug/m3 (x2),
+// index, ppb, ppm, 0.01 degC, 0.01 %RH, 0.1 mV
+#define TELEMETRY_PACKED_SCALES    { 100.0f, 10.0f, 100.0f, 10.0f, 10.0f, 1.0f, 1.0f, 1.0f, 100.0f, 100.0f, 10000.0f }
+#define TELEMETRY_PACKED_NAN       INT32_MIN
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    uint16_t record_size;
+    uint16_t field_count;
+    char     firmware[24];
+    uint16_t crc;
+} telemetry_bin_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint64_t timestamp_us;  // Monotonic time since boot (tools_h/timebase.h)
+    float    ms5607_temperature;
+    float    ms5607_pressure;
+    float    ms5607_altitude;
+    float    sds011_pm2_5;
+    float    sds011_pm10;
+    float    ens160_AQI;
+    float    ens160_TVOC;
+    float    ens160_eCO2;
+    float    aht21_temperature;
+    float    aht21_humidity;
+    float    mics5524_voltage;
+    uint16_t crc;
+} telemetry_record_t;
+
+_Static_assert(sizeof(telemetry_bin_header_t) == 38, "telemetry header layout changed");
+_Static_assert(sizeof(telemetry_record_t) == 54, "telemetry record layout changed");
+
+#endif /* INC_TOOLS_H_TELEMETRY_H_ */
@@ -0,0 +1,48 @@
+/*
+ * telemetry_codec.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef INC_TOOLS_H_TELEMETRY_CODEC_H_
+#define INC_TOOLS_H_TELEMETRY_CODEC_H_
+
+#include <stdint.h>
+#include "tools_h/telemetry.h"
+
+/* ========================== */
+/*   TELEMETRY COMPRESSION    */
+/* ========================== */
+
+/*
+ * Keyframe + delta encoding of telemetry_record_t for the SD card (record
+ * layout in tools_h/telemetry.h). Sensors refresh at different rates, so
+ * most fields are unchanged from one sample to the next and cost a mask
+ * bit; the ones that move do so by a few LSBs and fit one or two bytes.
+ */
+
+// Length byte + the largest body (10-byte timestamp, 2-byte mask, 5 bytes per field) + CRC
+#define TELEMETRY_PACKED_MAX      (1 + 10 + 2 + 5 * TELEMETRY_FIELD_COUNT + 1)
+#define TELEMETRY_PACKED_KEYFRAME 0x80u
+
+typedef struct {
+    uint64_t last_timestamp_us;
+    int64_t  last_interval_us;
+    int32_t  last[TELEMETRY_FIELD_COUNT];
+    uint32_t since_keyframe;            // 0: the next record is a keyframe
+} telemetry_encoder_t;
+
+/**
+ * Start a new stream: the next record is a keyframe. Call whenever the
+ * output file is (re)opened.
+ */
+void telemetry_encoder_reset(telemetry_encoder_t *enc);
+
+/**
+ * Encode one record into out (TELEMETRY_PACKED_MAX bytes).
+ * @return Number of bytes written.
+ */
+uint32_t telemetry_encode(telemetry_encoder_t *enc, const telemetry_record_t *record, uint8_t *out);
+
+#endif /* INC_TOOLS_H_TELEMETRY_CODEC_H_ */
@@ -0,0 +1,54 @@
+/*
+ * timebase.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef INC_TOOLS_H_TIMEBASE_H_
+#define INC_TOOLS_H_TIMEBASE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ========================== */
+/*       MONOTONIC CLOCK      */
+/* ========================== */
+
+/*
+ * TIM2 free-runs at 1 MHz over its full 32 bits; the update interrupt
+ * extends it to 64 bits, so timebase_us() never wraps. With
+ * TIMEBASE_LSE_DISCIPLINE the MSI (and with it the PLL and TIM2) is
+ * hardware-trimmed against the 32.768 kHz crystal.
+ */
+
+void timebase_init(void);
+
+/**
+ * Microseconds since timebase_init(). Safe from thread and interrupt
+ * context, including handlers that preempt the TIM2 interrupt.
+ */
+uint64_t timebase_us(void);
+
+/**
+ * Low 32 bits of timebase_us(), for short intervals (wraps after 71 min).
+ */
+uint32_t timebase_us32(void);
+
+/**
+ * True once the MSI is locked to the LSE. False when discipline is off
+ * or the crystal did not start.
+ */
+bool timebase_lse_locked(void);
+
+/**
+ * Splits a timebase_us() value into the HH:MM:SS:mmm fields of the logs.
+ */
+void timebase_split(uint64_t us, uint8_t *hour, uint8_t *min, uint8_t *sec, uint16_t *ms);
+
+/**
+ * TIM2 update interrupt. Called from TIM2_IRQHandler.
+ */
+void timebase_IRQHandler(void);
+
+#endif /* INC_TOOLS_H_TIMEBASE_H_ */
@@ -0,0 +1,62 @@
+/*
+ * uart_stream.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef INC_TOOLS_H_UART_STREAM_H_
+#define INC_TOOLS_H_UART_STREAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stm32l4xx_hal.h"
+#include "tools_h/ring.h"
+
+/* ========================== */
+/*    UART TX DMA STREAMS     */
+/* ========================== */
+
+/*
+ * A byte ring drained by UART TX DMA: the thread writes, the DMA sends the
+ * contiguous run at the tail and the transfer complete interrupt releases
+ * it and starts the next. The UART needs its hdmatx linked and its DMA and
+ * UART interrupts enabled (MspInit), and HAL_UART_TxCpltCallback /
+ * HAL_UART_ErrorCallback must be forwarded to the stream.
+ */
+
+typedef struct {
+    Ring ring;
+    UART_HandleTypeDef *huart;
+    volatile uint32_t in_flight;    // Bytes owned by the DMA, 0 when the UART is idle
+} UartStream;
+
+/* Static initialiser, for streams that must work before any init code runs */
+#define UART_STREAM_INIT(storage, size, uart) \
+    { { (storage), 1, (size) - 1, 0, 0, 0 }, (uart), 0 }
+
+/**
+ * size must be a power of two. Returns false otherwise.
+ */
+bool uart_stream_init(UartStream *stream, UART_HandleTypeDef *huart, void *storage, uint32_t size);
+
+/**
+ * Queue len bytes from thread context and start the DMA if it is idle.
+ * Returns false if they were dropped whole (counted in ring.dropped).
+ */
+bool uart_stream_write(UartStream *stream, const void *data, uint32_t len);
+
+/* Bytes queued or in flight */
+uint32_t uart_stream_pending(const UartStream *stream);
+
+/**
+ * Restarts an idle stream with queued bytes. Not needed after a write;
+ * covers a write that found the DMA busy just as it finished.
+ */
+void uart_stream_kick(UartStream *stream);
+
+/* From HAL_UART_TxCpltCallback / HAL_UART_ErrorCallback; ignore other UARTs */
+void uart_stream_TxCpltCallback(UartStream *stream, UART_HandleTypeDef *huart);
+void uart_stream_ErrorCallback(UartStream *stream, UART_HandleTypeDef *huart);
+
+#endif /* INC_TOOLS_H_UART_STREAM_H_ */
@@ -7,11 +7,15 @@
 
 #include "drivers_h/aht21.h"
 #include <string.h>
+#include <stdbool.h>
 
 
 uint8_t AHT_21_ADDR = 0x38 << 1;
 uint32_t i2c_RETRY_TIME = 100;
 
+static bool measurementPending;
+static uint32_t measurementStart;
+
 HAL_StatusTypeDef AHT21_init(void) {
 	HAL_StatusTypeDef ret;
 	uint8_t buff[8];
@@ -36,49 +40,83 @@ HAL_StatusTypeDef AHT21_init(void) {
 	return ret;
 }
 
-uint32_t AHT21_Read_Humidity(void) {
+static uint8_t AHT21_CRC8(const uint8_t *data, uint8_t len) {
+	uint8_t crc = 0xFF;	// CRC-8, polynomial x^8 + x^5 + x^4 + 1
+
+	while (len--) {
+		crc ^= *data++;
+		for (uint8_t i = 0; i < 8; i++) {
+			crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+HAL_StatusTypeDef AHT21_StartMeasurement(void) {
+	uint8_t buff[3] = { 0xAC, 0x33, 0x00 };
 	HAL_StatusTypeDef ret;
-	uint8_t buff[8];
-	uint32_t humidity;
 
-	buff[0] = 0xAC;
-	buff[1] = 0X33;
-	buff[2] = 0x00;
+	measurementPending = false;
 	ret = HAL_I2C_Master_Transmit(&AHT21_I2C_PORT, AHT_21_ADDR, buff, 3,
 			i2c_RETRY_TIME);
 	if (ret != HAL_OK) {
-		return HAL_ERROR;
+		return (ret == HAL_BUSY) ? HAL_BUSY : HAL_ERROR;	// HAL_BUSY: bus owned by an interrupt-driven transfer
 	}
-	//HAL_Delay(100);
-	ret = HAL_I2C_Master_Receive(&AHT21_I2C_PORT, AHT_21_ADDR, buff, 6,
-			i2c_RETRY_TIME);
-	//CALCULATING HUMIDITY
-	humidity = (buff[1] << 12) | (buff[2] << 4) | (buff[3] >> 4);
-	humidity = (humidity * 100);
-	humidity = humidity / 0x100000;
-	return humidity;
+	measurementStart = HAL_GetTick();
+	measurementPending = true;
+	return HAL_OK;
 }
 
-int32_t AHT21_Read_Temperature(void) {
+HAL_StatusTypeDef AHT21_GetMeasurement(AHT21_Data *data) {
+	uint8_t buff[7];
 	HAL_StatusTypeDef ret;
-	uint8_t buff[8];
-	uint32_t temperature;
 
-	buff[0] = 0xAC;
-	buff[1] = 0X33;
-	buff[2] = 0x00;
-	ret = HAL_I2C_Master_Transmit(&AHT21_I2C_PORT, AHT_21_ADDR, buff, 3,
+	if (!measurementPending) {
+		return HAL_ERROR;
+	}
+	if (HAL_GetTick() - measurementStart < AHT21_MEASUREMENT_MS) {
+		return HAL_BUSY;
+	}
+
+	// Status, 20 bits humidity, 20 bits temperature, CRC
+	ret = HAL_I2C_Master_Receive(&AHT21_I2C_PORT, AHT_21_ADDR, buff, 7,
 			i2c_RETRY_TIME);
+	if (ret == HAL_BUSY) {
+		return HAL_BUSY;
+	}
 	if (ret != HAL_OK) {
+		measurementPending = false;
 		return HAL_ERROR;
 	}
-	//HAL_Delay(100);
-	ret = HAL_I2C_Master_Receive(&AHT21_I2C_PORT, AHT_21_ADDR, buff, 6,
-			i2c_RETRY_TIME);
-	//CALCULATING TEMPERATURE
-	temperature = ((buff[3] & 0xF) << 16) | (buff[4] << 8) | (buff[5]);
-	temperature = (temperature * 200);
-	temperature = temperature / 0x100000;
-	temperature = temperature - 50;
-	return temperature;
+	if (buff[0] & 0x80) {
+		return HAL_BUSY;
+	}
+	measurementPending = false;
+	if (AHT21_CRC8(buff, 6) != buff[6]) {
+		return HAL_ERROR;
+	}
+
+	uint32_t humidity = ((uint32_t)buff[1] << 12) | ((uint32_t)buff[2] << 4) | (buff[3] >> 4);
+	uint32_t temperature = (((uint32_t)buff[3] & 0x0F) << 16) | ((uint32_t)buff[4] << 8) | buff[5];
+	data->humidity = (float)humidity * (100.0f / 1048576.0f);
+	data->temperature = (float)temperature * (200.0f / 1048576.0f) - 50.0f;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef AHT21_Read(AHT21_Data *data) {
+	HAL_StatusTypeDef ret = AHT21_StartMeasurement();
+	uint32_t start = HAL_GetTick();
+
+	while (ret == HAL_OK || ret == HAL_BUSY) {
+		HAL_Delay(ret == HAL_OK ? AHT21_MEASUREMENT_MS : 5);
+		ret = AHT21_GetMeasurement(data);
+		if (ret == HAL_OK) {
+			return HAL_OK;
+		}
+		if (HAL_GetTick() - start > 4 * AHT21_MEASUREMENT_MS) {
+			measurementPending = false;
+			return HAL_TIMEOUT;
+		}
+	}
+	return HAL_ERROR;
 }
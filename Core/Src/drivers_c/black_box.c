@@ -7,10 +7,19 @@
 
 #include <drivers_h/black_box.h>
 #include "fatfs.h"
+#include "diskio.h"
+#include "user_diskio_spi.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "tools_h/configuration.h"
+#include "tools_h/telemetry.h"
+#include "tools_h/crc.h"
+#include "tools_h/telemetry_codec.h"
+#include "tools_h/lz_stream.h"
+#include "tools_h/timebase.h"
+#include "tools_h/event_log.h"
 
 // SD Card objects
 FATFS fs;
@@ -19,15 +28,82 @@ BYTE work[4096];
 
 
 
-// Logging file handles and counters
-static FIL log_fil;
-static FIL telemetry_fil;
-static bool log_file_ready = false;
-static bool telemetry_file_ready = false;
-static uint32_t log_write_counter = 0;
-static uint32_t telemetry_write_counter = 0;
+#define SD_SECTOR_SIZE 512
+#define BB_CLMT_SIZE   8    // Fast-seek table entries: a contiguous file needs 4
+
+_Static_assert(BB_STREAM_BUFFER_SIZE % SD_SECTOR_SIZE == 0, "BB_STREAM_BUFFER_SIZE must be a multiple of the sector size");
+
+/*
+ * Buffered output stream: records are copied into one of two RAM buffers.
+ * A full buffer is handed to f_write as whole sectors (the file offset is
+ * kept sector-aligned, so FatFs writes it straight to the card without going
+ * through its own sector buffer) either from black_box_service() or, if the
+ * caller never services us, when the other buffer fills up too.
+ * Files stay open for the whole session and are synced on a time/byte budget.
+ *
+ * A stream opened with a reservation gets its whole mission size allocated
+ * as one contiguous cluster run up front (f_expand) and a fast-seek table, so
+ * f_write never walks or extends the FAT while flying. The unused tail is
+ * cut off again when the stream is closed.
+ *
+ * A failed f_write or f_sync closes the file and drops what is buffered. The
+ * next write reopens it at the last offset FatFs accepted, not at its end:
+ * the file size on the card covers the whole reservation, which is kept,
+ * fast-seek table included.
+ */
+typedef struct {
+    FIL      fil;
+    bool     open;
+    uint8_t  buf[2][BB_STREAM_BUFFER_SIZE];
+    uint8_t  active;            // Buffer currently being filled
+    bool     pending;           // The other buffer is full and waits for f_write
+    UINT     pending_len;
+    UINT     fill;              // Bytes in the active buffer
+    UINT     limit;             // Fill level that ends on a sector boundary
+    FSIZE_t  written;           // Bytes handed to FatFs so far
+    uint32_t bytes_since_sync;
+    uint32_t last_sync_tick;
+    FSIZE_t  reserved;          // Preallocated file size, 0 if the file grows cluster by cluster
+    DWORD    clmt[BB_CLMT_SIZE];
+    bool     failed;            // Closed by a write failure: reopen at written, not at the end
+} bb_stream_t;
+
+// Logging streams
+static bb_stream_t log_stream;
+#ifdef EVENT_LOG_TOKENIZED
+static bb_stream_t event_stream;
+#endif
+#ifdef TELEMETRY_FORMAT_CSV
+static bb_stream_t telemetry_stream;
+#endif
+#ifdef TELEMETRY_FORMAT_BINARY
+static bb_stream_t telemetry_bin_stream;
+#endif
+#if defined(TELEMETRY_FORMAT_BINARY) && defined(TELEMETRY_COMPRESSION)
+static telemetry_encoder_t telemetry_encoder;
+#endif
+#ifdef EVENT_LOG_COMPRESSION
+// Between the event formatter and the event file (eventsNNN.lz, or logsNNN.lz for the text log)
+static SRAM2_NOINIT lz_stream_t event_lz;
+#endif
+#ifdef EVENT_LOG_TOKENIZED
+static char event_filename[32] = "events.bin";
+#else
 static char log_filename[32] = "logs.csv";
+#endif
+#ifdef EVENT_LOG_COMPRESSION
+#define EVENT_FILE_EXT "lz"
+#elif defined(EVENT_LOG_TOKENIZED)
+#define EVENT_FILE_EXT "bin"
+#else
+#define EVENT_FILE_EXT "csv"
+#endif
+#ifdef TELEMETRY_FORMAT_CSV
 static char telemetry_filename[32] = "telemetry.csv";
+#endif
+#ifdef TELEMETRY_FORMAT_BINARY
+static char telemetry_bin_filename[32] = "telemetry.bin";
+#endif
 
 // FatFS result strings for debug
 const char* fresultStrings[] = {
@@ -62,6 +138,7 @@ int8_t mount_sd_card(){
         return 1;
     } else {
         printf("*              SD Card mounted successfully!            *\r\n");
+        printf("SD SPI clock: %lu kHz\r\n", (unsigned long)(USER_SPI_clock_hz() / 1000));
         return 0;
     }
 }
@@ -95,128 +172,543 @@ void check_free_space(void) {
            total_GB, free_GB);
 }
 
-// --- Internal: Write file header if missing, open for append ---
-static FRESULT ensure_file_with_header(const char* filename, const char* header, FIL* f) {
-    if (!file_exists(filename)) {
-        FRESULT res = f_open(f, filename, FA_CREATE_ALWAYS | FA_WRITE);
-        if (res == FR_OK) {
-            UINT bw;
-            f_write(f, header, strlen(header), &bw);
-            f_sync(f);
-            f_close(f);
-        } else {
+// --- Internal: buffered streams ---
+static void bb_stream_fail(bb_stream_t* s, const char* what, FRESULT res, UINT bw) {
+    printf("%s file write failed! FR = %d, bytes = %u\r\n", what, res, bw);
+    f_close(&s->fil);
+    s->open = false;
+    s->failed = true;
+}
+
+static void bb_stream_set_limit(bb_stream_t* s, FSIZE_t next_offset) {
+    s->limit = BB_STREAM_BUFFER_SIZE - (UINT)(next_offset % SD_SECTOR_SIZE);
+}
+
+static bool bb_stream_write_buffer(bb_stream_t* s, const uint8_t* data, UINT len, const char* what) {
+    UINT bw;
+    FRESULT res;
+
+    if (s->fil.cltbl && s->written + len > s->reserved) {
+        // Reservation used up: fast-seek mode cannot extend the file, fall back to the FAT
+        s->fil.cltbl = NULL;
+    }
+    res = f_write(&s->fil, data, len, &bw);
+    if (res != FR_OK || bw != len) {
+        bb_stream_fail(s, what, res, bw);
+        return false;
+    }
+    s->written += len;
+    s->bytes_since_sync += len;
+    return true;
+}
+
+static bool bb_stream_write_pending(bb_stream_t* s, const char* what) {
+    if (!s->pending) return true;
+    s->pending = false;
+    return bb_stream_write_buffer(s, s->buf[s->active ^ 1], s->pending_len, what);
+}
+
+// Writes out whatever is buffered, including a partially filled buffer
+static bool bb_stream_drain(bb_stream_t* s, const char* what) {
+    if (!bb_stream_write_pending(s, what)) return false;
+    if (s->fill == 0) return true;
+    UINT len = s->fill;
+    s->fill = 0;
+    if (!bb_stream_write_buffer(s, s->buf[s->active], len, what)) return false;
+    bb_stream_set_limit(s, s->written);
+    return true;
+}
+
+static bool bb_stream_sync(bb_stream_t* s, const char* what) {
+    FRESULT res = f_sync(&s->fil);
+    s->bytes_since_sync = 0;
+    s->last_sync_tick = HAL_GetTick();
+    if (res != FR_OK) {
+        bb_stream_fail(s, what, res, 0);
+        return false;
+    }
+    return true;
+}
+
+static bool bb_stream_write(bb_stream_t* s, const void* data, UINT len, const char* what) {
+    const uint8_t* p = (const uint8_t*)data;
+
+    while (len > 0) {
+        UINT room = s->limit - s->fill;
+        UINT n = (len < room) ? len : room;
+        memcpy(&s->buf[s->active][s->fill], p, n);
+        s->fill += n;
+        p += n;
+        len -= n;
+
+        if (s->fill == s->limit) {
+            // Both buffers full: the caller is not servicing us, write inline
+            if (!bb_stream_write_pending(s, what)) return false;
+            s->pending = true;
+            s->pending_len = s->fill;
+            s->active ^= 1;
+            s->fill = 0;
+            bb_stream_set_limit(s, s->written + s->pending_len);
+        }
+    }
+    return true;
+}
+
+// Fast-seek table over the clusters the file already has
+static bool bb_stream_link(bb_stream_t* s, const char* what) {
+    s->clmt[0] = BB_CLMT_SIZE;
+    s->fil.cltbl = s->clmt;
+    FRESULT res = f_lseek(&s->fil, CREATE_LINKMAP);
+    if (res != FR_OK) {
+        s->fil.cltbl = NULL;
+        printf("%s file: fast-seek table failed (FR = %d)\r\n", what, res);
+        return false;
+    }
+    return true;
+}
+
+// Allocates the file as one contiguous run, erases it and builds the fast-seek table
+static void bb_stream_reserve(bb_stream_t* s, FSIZE_t size, const char* what) {
+    FRESULT res = f_expand(&s->fil, size, 1);
+    if (res != FR_OK) {
+        printf("%s file: no contiguous %lu bytes (FR = %d), growing on demand\r\n",
+               what, (unsigned long)size, res);
+        return;
+    }
+
+    // Tell the card the whole run will be streamed so it can pre-erase it
+    DWORD sectors = (DWORD)((size + SD_SECTOR_SIZE - 1) / SD_SECTOR_SIZE);
+    DWORD clusters = (sectors + fs.csize - 1) / fs.csize;
+    DWORD region[2] = {
+        fs.database + (s->fil.obj.sclust - 2) * fs.csize,
+        clusters * fs.csize
+    };
+    disk_ioctl(fs.drv, CTRL_STREAM_PREERASE, region);
+
+    if (bb_stream_link(s, what)) {
+        s->reserved = size;
+    }
+}
+
+// Reopened after a failure: back to the last byte FatFs accepted, inside what is left of the reservation
+static FRESULT bb_stream_resume(bb_stream_t* s, FSIZE_t reserve, const char* what) {
+    FSIZE_t size = f_size(&s->fil);
+    if (s->written > size) {
+        // The directory entry was never synced past this point
+        s->written = size;
+    }
+    if (reserve > 0 && size > s->written && bb_stream_link(s, what)) {
+        s->reserved = size;
+    }
+    return f_lseek(&s->fil, s->written);
+}
+
+static FRESULT bb_stream_open(bb_stream_t* s, const char* filename, FSIZE_t reserve,
+                              const void* header, UINT header_len) {
+    bool exists = file_exists(filename);
+    bool resume = s->failed && exists;
+    FRESULT res = f_open(&s->fil, filename, (resume ? FA_OPEN_ALWAYS : FA_OPEN_APPEND) | FA_WRITE);
+    if (res != FR_OK) {
+        return res;
+    }
+
+    s->active = 0;
+    s->pending = false;
+    s->pending_len = 0;
+    s->fill = 0;
+    s->bytes_since_sync = 0;
+    s->last_sync_tick = HAL_GetTick();
+    s->reserved = 0;
+    s->failed = false;
+
+    if (resume) {
+        res = bb_stream_resume(s, reserve, filename);
+        if (res != FR_OK) {
+            f_close(&s->fil);
+            s->failed = true;
             return res;
         }
+    } else {
+        s->written = f_size(&s->fil);
+        if (reserve > 0 && s->written == 0) {
+            bb_stream_reserve(s, reserve, filename);
+        }
+    }
+    s->open = true;
+    bb_stream_set_limit(s, s->written);
+
+    if (!exists) {
+        bb_stream_write(s, header, header_len, "Header");
     }
-    // Open for appending
-    return f_open(f, filename, FA_OPEN_APPEND | FA_WRITE);
+    return FR_OK;
 }
 
-// --- Init and flush functions ---
+static void bb_stream_service(bb_stream_t* s, const char* what) {
+    if (!s->open) return;
+    if (!bb_stream_write_pending(s, what)) return;
+
+    if ((HAL_GetTick() - s->last_sync_tick) >= BB_SYNC_INTERVAL_MS) {
+        if (bb_stream_drain(s, what)) {
+            bb_stream_sync(s, what);
+        }
+    } else if (s->bytes_since_sync >= BB_SYNC_BYTES) {
+        bb_stream_sync(s, what);
+    }
+}
+
+static void bb_stream_close(bb_stream_t* s, const char* what) {
+    if (!s->open) return;
+    if (!bb_stream_drain(s, what)) return;
+
+    if (f_size(&s->fil) > s->written) {
+        // Give back the unused part of the reservation
+        FRESULT res = f_lseek(&s->fil, s->written);
+        if (res == FR_OK) {
+            s->fil.cltbl = NULL;
+            res = f_truncate(&s->fil);
+        }
+        if (res != FR_OK) {
+            printf("%s file truncate failed! FR = %d\r\n", what, res);
+        }
+    }
+
+    if (bb_stream_sync(s, what)) {
+        f_close(&s->fil);
+        s->open = false;
+    }
+}
+
+// --- Compressed streams: an lz header, then the plain header and records through event_lz ---
+#ifdef EVENT_LOG_COMPRESSION
+static void bb_lz_sink(void* ctx, const uint8_t* data, uint32_t len) {
+    bb_stream_write((bb_stream_t*)ctx, data, len, "Event");
+}
+
+static FRESULT bb_lz_open(bb_stream_t* s, const char* filename, const void* header, UINT header_len) {
+    lz_file_header_t lz_header = {
+        .magic = LZ_FILE_MAGIC,
+        .version = LZ_FILE_VERSION,
+        .window_size = LZ_WINDOW_SIZE,
+    };
+    bool exists = file_exists(filename);
+    FRESULT res = bb_stream_open(s, filename, 0, &lz_header, sizeof(lz_header));
+    if (res != FR_OK) {
+        return res;
+    }
+
+    // A reopened file continues with a fresh history: no match reaches into the old part.
+    // The old part may end inside a group, so the new stream gets its own lz header to restart at.
+    lz_stream_init(&event_lz, bb_lz_sink, s);
+    if (!exists) {
+        lz_stream_write(&event_lz, header, header_len);
+    } else {
+        bb_stream_write(s, &lz_header, sizeof(lz_header), "Event");
+    }
+    return FR_OK;
+}
+
+// Pushes the lookahead out when the stream is due for its periodic sync, so it goes to the card with it
+static void bb_lz_service(bb_stream_t* s) {
+    if (s->open && (HAL_GetTick() - s->last_sync_tick) >= BB_SYNC_INTERVAL_MS) {
+        lz_stream_flush(&event_lz);
+    }
+}
+
+static void bb_lz_close(bb_stream_t* s) {
+    if (!s->open) return;
+    lz_stream_flush(&event_lz);
+    printf("Event log compressed: %lu -> %lu bytes\r\n",
+           (unsigned long)event_lz.bytes_in, (unsigned long)event_lz.bytes_out);
+}
+#endif
+
+// --- Stream openers (header written only into new files) ---
+#ifndef EVENT_LOG_TOKENIZED
+static FRESULT open_log_stream(void) {
+    const char* header = "TIMESTAMP,LOG_LEVEL,MESSAGE\r\n";
+#ifdef EVENT_LOG_COMPRESSION
+    return bb_lz_open(&log_stream, log_filename, header, strlen(header));
+#else
+    return bb_stream_open(&log_stream, log_filename, 0, header, strlen(header));
+#endif
+}
+#endif
+
+#ifdef EVENT_LOG_TOKENIZED
+static FRESULT open_event_stream(void) {
+    event_log_header_t header = {
+        .magic = EVENT_LOG_MAGIC,
+        .version = EVENT_LOG_VERSION,
+        .header_size = sizeof(event_log_header_t),
+        .token_count = LOG_TOKEN_COUNT,
+    };
+    strncpy(header.firmware, FIRMWARE_VERSION, sizeof(header.firmware));
+    header.crc = crc16_ccitt(&header, offsetof(event_log_header_t, crc), CRC16_CCITT_INIT);
+
+#ifdef EVENT_LOG_COMPRESSION
+    return bb_lz_open(&event_stream, event_filename, &header, sizeof(header));
+#else
+    return bb_stream_open(&event_stream, event_filename, 0, &header, sizeof(header));
+#endif
+}
+#endif
+
+#ifdef TELEMETRY_FORMAT_CSV
+static FRESULT open_telemetry_stream(void) {
+    const char* header = "TIMESTAMP,TIME_S,ms5607_temperature,ms5607_pressure,ms5607_altitude,"
+                         "sds011_pm2_5,sds011_pm10,ens160_AQI,ens160_TVOC,ens160_eCO2,"
+                         "aht21_temperature,aht21_humidity,mics5524_voltage\r\n";
+    return bb_stream_open(&telemetry_stream, telemetry_filename, TELEMETRY_PREALLOC_SIZE,
+                          header, strlen(header));
+}
+#endif
+
+#ifdef TELEMETRY_FORMAT_BINARY
+static FRESULT open_telemetry_bin_stream(void) {
+    telemetry_bin_header_t header = {
+        .magic = TELEMETRY_BIN_MAGIC,
+#ifdef TELEMETRY_COMPRESSION
+        .version = TELEMETRY_BIN_VERSION_PACKED,
+        .record_size = 0,
+#else
+        .version = TELEMETRY_BIN_VERSION,
+        .record_size = sizeof(telemetry_record_t),
+#endif
+        .header_size = sizeof(telemetry_bin_header_t),
+        .field_count = TELEMETRY_FIELD_COUNT,
+    };
+#ifdef TELEMETRY_COMPRESSION
+    telemetry_encoder_reset(&telemetry_encoder);
+#endif
+    strncpy(header.firmware, FIRMWARE_VERSION, sizeof(header.firmware));
+    header.crc = crc16_ccitt(&header, offsetof(telemetry_bin_header_t, crc), CRC16_CCITT_INIT);
+
+    return bb_stream_open(&telemetry_bin_stream, telemetry_bin_filename, TELEMETRY_PREALLOC_SIZE,
+                          &header, sizeof(header));
+}
+#endif
+
+// --- Init, service and flush functions ---
 void black_box_init(void) {
-    log_file_ready = false;
-    telemetry_file_ready = false;
-    log_write_counter = 0;
-    telemetry_write_counter = 0;
+    log_stream.open = false;
+#ifdef EVENT_LOG_TOKENIZED
+    event_stream.open = false;
+#endif
+#ifdef TELEMETRY_FORMAT_CSV
+    telemetry_stream.open = false;
+#endif
+#ifdef TELEMETRY_FORMAT_BINARY
+    telemetry_bin_stream.open = false;
+#endif
     // Generate unique filenames for this session
-    get_next_available_filename("logs", "csv", log_filename, sizeof(log_filename));
+#ifdef EVENT_LOG_TOKENIZED
+    get_next_available_filename("events", EVENT_FILE_EXT, event_filename, sizeof(event_filename));
+#else
+    get_next_available_filename("logs", EVENT_FILE_EXT, log_filename, sizeof(log_filename));
+#endif
+#ifdef TELEMETRY_FORMAT_CSV
     get_next_available_filename("telemetry", "csv", telemetry_filename, sizeof(telemetry_filename));
+#endif
+#ifdef TELEMETRY_FORMAT_BINARY
+    get_next_available_filename("telemetry", "bin", telemetry_bin_filename, sizeof(telemetry_bin_filename));
+#endif
+
+    // Telemetry files are opened (and preallocated) now, not on the first record in flight
+    FRESULT res;
+#ifdef TELEMETRY_FORMAT_CSV
+    res = open_telemetry_stream();
+    if (res != FR_OK) printf("Can't open telemetry file! FR = %d\r\n", res);
+#endif
+#ifdef TELEMETRY_FORMAT_BINARY
+    res = open_telemetry_bin_stream();
+    if (res != FR_OK) printf("Can't open telemetry file! FR = %d\r\n", res);
+#endif
+    (void)res;
 }
 
+void black_box_service(void) {
+#if defined(EVENT_LOG_COMPRESSION) && !defined(EVENT_LOG_TOKENIZED)
+    bb_lz_service(&log_stream);
+#endif
+    bb_stream_service(&log_stream, "Log");
+#ifdef EVENT_LOG_TOKENIZED
+#ifdef EVENT_LOG_COMPRESSION
+    bb_lz_service(&event_stream);
+#endif
+    bb_stream_service(&event_stream, "Event");
+#endif
+#ifdef TELEMETRY_FORMAT_CSV
+    bb_stream_service(&telemetry_stream, "Telemetry");
+#endif
+#ifdef TELEMETRY_FORMAT_BINARY
+    bb_stream_service(&telemetry_bin_stream, "Telemetry");
+#endif
+}
 
 void black_box_flush_all(void) {
-    if (log_file_ready) {
-        f_sync(&log_fil);
-        f_close(&log_fil);
-        log_file_ready = false;
-    }
-    if (telemetry_file_ready) {
-        f_sync(&telemetry_fil);
-        f_close(&telemetry_fil);
-        telemetry_file_ready = false;
-    }
+#if defined(EVENT_LOG_COMPRESSION) && !defined(EVENT_LOG_TOKENIZED)
+    bb_lz_close(&log_stream);
+#endif
+    bb_stream_close(&log_stream, "Log");
+#ifdef EVENT_LOG_TOKENIZED
+#ifdef EVENT_LOG_COMPRESSION
+    bb_lz_close(&event_stream);
+#endif
+    bb_stream_close(&event_stream, "Event");
+#endif
+#ifdef TELEMETRY_FORMAT_CSV
+    bb_stream_close(&telemetry_stream, "Telemetry");
+#endif
+#ifdef TELEMETRY_FORMAT_BINARY
+    bb_stream_close(&telemetry_bin_stream, "Telemetry");
+#endif
 }
 
-// --- Event Logging: logs.csv ---
+// --- Event Logging: logs.csv, or text records in events.bin ---
 void log_event(uint8_t hour, uint8_t min, uint8_t sec, uint16_t ms,
                const char* log_level, const char* message) {
+#ifdef EVENT_LOG_TOKENIZED
+    (void)hour; (void)min; (void)sec; (void)ms;
+    event_log(EVT_TEXT, log_level, message);
+#else
     FRESULT res;
     char line[256];
 
-    if (!log_file_ready) {
-        const char* header = "TIMESTAMP,LOG_LEVEL,MESSAGE\r\n";
-        res = ensure_file_with_header(log_filename, header, &log_fil);
+    if (!log_stream.open) {
+        res = open_log_stream();
         if (res != FR_OK) {
             printf("Can't open log file! FR = %d\r\n", res);
             return;
         }
-        log_file_ready = true;
-        log_write_counter = 0;
     }
 
-    snprintf(line, sizeof(line), "%02u:%02u:%02u:%03u,%s,%s\r\n",
-             hour, min, sec, ms, log_level, message);
+    int len = snprintf(line, sizeof(line), "%02u:%02u:%02u:%03u,%s,%s\r\n",
+                       hour, min, sec, ms, log_level, message);
+    if (len < 0) return;
+    if (len >= (int)sizeof(line)) len = sizeof(line) - 1;
 
-    UINT bw;
-    res = f_write(&log_fil, line, strlen(line), &bw);
-    if (res != FR_OK || bw != strlen(line)) {
-        printf("Log file write failed! FR = %d, bytes = %u\r\n", res, bw);
-        log_file_ready = false;
-        f_close(&log_fil);
-        return;
-    }
+#ifdef EVENT_LOG_COMPRESSION
+    lz_stream_write(&event_lz, line, (uint32_t)len);
+#else
+    bb_stream_write(&log_stream, line, (UINT)len, "Log");
+#endif
+#endif
+}
 
-    log_write_counter++;
-    if (log_write_counter >= LOG_BURST_N) {
-        f_sync(&log_fil);
-        f_close(&log_fil);
-        log_file_ready = false;
+#ifdef EVENT_LOG_TOKENIZED
+void black_box_write_event(const void* record, uint16_t len) {
+    if (!event_stream.open) {
+        FRESULT res = open_event_stream();
+        if (res != FR_OK) {
+            printf("Can't open event file! FR = %d\r\n", res);
+            return;
+        }
     }
+#ifdef EVENT_LOG_COMPRESSION
+    lz_stream_write(&event_lz, record, len);
+#else
+    bb_stream_write(&event_stream, record, len, "Event");
+#endif
 }
+#endif
 
 // --- Telemetry Logging: telemetry.csv ---
-void log_telemetry(uint8_t hour, uint8_t min, uint8_t sec, uint16_t ms,
-                   float ms5607_temperature, float ms5607_pressure, float ms5607_altitude,
-                   float sds011_pm2_5, float sds011_pm10,
-                   float ens160_AQI, float ens160_TVOC, float ens160_eCO2,
-                   float aht21_temperature, float aht21_humidity) {
+#ifdef TELEMETRY_FORMAT_CSV
+static void log_telemetry_csv(uint64_t timestamp_us,
+                              float ms5607_temperature, float ms5607_pressure, float ms5607_altitude,
+                              float sds011_pm2_5, float sds011_pm10,
+                              float ens160_AQI, float ens160_TVOC, float ens160_eCO2,
+                              float aht21_temperature, float aht21_humidity,
+                              float mics5524_voltage) {
     FRESULT res;
     char line[320];
+    uint8_t hour, min, sec;
+    uint16_t ms;
 
-    if (!telemetry_file_ready) {
-        const char* header = "TIMESTAMP,ms5607_temperature,ms5607_pressure,ms5607_altitude,"
-                             "sds011_pm2_5,sds011_pm10,ens160_AQI,ens160_TVOC,ens160_eCO2,"
-                             "aht21_temperature,aht21_humidity\r\n";
-        res = ensure_file_with_header(telemetry_filename, header, &telemetry_fil);
+    if (!telemetry_stream.open) {
+        res = open_telemetry_stream();
         if (res != FR_OK) {
             printf("Can't open telemetry file! FR = %d\r\n", res);
             return;
         }
-        telemetry_file_ready = true;
-        telemetry_write_counter = 0;
     }
 
-    snprintf(line, sizeof(line),
-             "%02u:%02u:%02u:%03u,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\r\n",
-             hour, min, sec, ms,
-             ms5607_temperature, ms5607_pressure, ms5607_altitude,
-             sds011_pm2_5, sds011_pm10,
-             ens160_AQI, ens160_TVOC, ens160_eCO2,
-             aht21_temperature, aht21_humidity);
+    timebase_split(timestamp_us, &hour, &min, &sec, &ms);
+    int len = snprintf(line, sizeof(line),
+                       "%02u:%02u:%02u:%03u,%lu.%06lu,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.3f\r\n",
+                       hour, min, sec, ms,
+                       (unsigned long)(timestamp_us / 1000000U), (unsigned long)(timestamp_us % 1000000U),
+                       ms5607_temperature, ms5607_pressure, ms5607_altitude,
+                       sds011_pm2_5, sds011_pm10,
+                       ens160_AQI, ens160_TVOC, ens160_eCO2,
+                       aht21_temperature, aht21_humidity,
+                       mics5524_voltage);
+    if (len < 0) return;
+    if (len >= (int)sizeof(line)) len = sizeof(line) - 1;
 
-    UINT bw;
-    res = f_write(&telemetry_fil, line, strlen(line), &bw);
-    if (res != FR_OK || bw != strlen(line)) {
-        printf("Telemetry file write failed! FR = %d, bytes = %u\r\n", res, bw);
-        telemetry_file_ready = false;
-        f_close(&telemetry_fil);
-        return;
+    bb_stream_write(&telemetry_stream, line, (UINT)len, "Telemetry");
+}
+#endif
+
+// --- Telemetry Logging: telemetry.bin ---
+#ifdef TELEMETRY_FORMAT_BINARY
+static void log_telemetry_binary(const telemetry_record_t* record) {
+    FRESULT res;
+
+    if (!telemetry_bin_stream.open) {
+        res = open_telemetry_bin_stream();
+        if (res != FR_OK) {
+            printf("Can't open telemetry file! FR = %d\r\n", res);
+            return;
+        }
     }
 
-    telemetry_write_counter++;
-    if (telemetry_write_counter >= TELEMETRY_BURST_N) {
-        f_sync(&telemetry_fil);
-        f_close(&telemetry_fil);
-        telemetry_file_ready = false;
+#ifdef TELEMETRY_COMPRESSION
+    uint8_t packed[TELEMETRY_PACKED_MAX];
+    uint32_t len = telemetry_encode(&telemetry_encoder, record, packed);
+    if (!bb_stream_write(&telemetry_bin_stream, packed, len, "Telemetry")) {
+        // Deltas must not refer to a record that never reached the card
+        telemetry_encoder_reset(&telemetry_encoder);
     }
+#else
+    bb_stream_write(&telemetry_bin_stream, record, sizeof(*record), "Telemetry");
+#endif
+}
+#endif
+
+void log_telemetry(uint64_t timestamp_us,
+                   float ms5607_temperature, float ms5607_pressure, float ms5607_altitude,
+                   float sds011_pm2_5, float sds011_pm10,
+                   float ens160_AQI, float ens160_TVOC, float ens160_eCO2,
+                   float aht21_temperature, float aht21_humidity,
+                   float mics5524_voltage) {
+#ifdef TELEMETRY_FORMAT_BINARY
+    telemetry_record_t record = {
+        .timestamp_us = timestamp_us,
+        .ms5607_temperature = ms5607_temperature,
+        .ms5607_pressure = ms5607_pressure,
+        .ms5607_altitude = ms5607_altitude,
+        .sds011_pm2_5 = sds011_pm2_5,
+        .sds011_pm10 = sds011_pm10,
+        .ens160_AQI = ens160_AQI,
+        .ens160_TVOC = ens160_TVOC,
+        .ens160_eCO2 = ens160_eCO2,
+        .aht21_temperature = aht21_temperature,
+        .aht21_humidity = aht21_humidity,
+        .mics5524_voltage = mics5524_voltage,
+    };
+#ifndef TELEMETRY_COMPRESSION
+    record.crc = crc16_ccitt(&record, offsetof(telemetry_record_t, crc), CRC16_CCITT_INIT);
+#endif
+    log_telemetry_binary(&record);
+#endif
+
+#ifdef TELEMETRY_FORMAT_CSV
+    log_telemetry_csv(timestamp_us,
+                      ms5607_temperature, ms5607_pressure, ms5607_altitude,
+                      sds011_pm2_5, sds011_pm10,
+                      ens160_AQI, ens160_TVOC, ens160_eCO2,
+                      aht21_temperature, aht21_humidity,
+                      mics5524_voltage);
+#endif
 }
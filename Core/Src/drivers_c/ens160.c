@@ -23,6 +23,9 @@ void ENS160_Init(ENS160_t *dev) {
     dev->aqi     = 0;
     dev->tvoc    = 0;
     dev->eco2    = 0;
+    dev->xfer    = ENS160_XFER_IDLE;
+    dev->new_data = false;
+    dev->errors  = 0;
     // Optionally, perform a reset
     ENS160_SoftwareReset(dev);
     HAL_Delay(10);
@@ -75,29 +78,82 @@ uint8_t ENS160_SetTempAndRH(ENS160_t *dev, float temp_celsius, float rh_percent)
     return ENS160_OK;
 }
 
+// AQI, TVOC and ECO2 are contiguous: one transfer for the whole block
+static void ENS160_ParseData(ENS160_t *dev, const uint8_t *data) {
+    dev->aqi  = data[0];
+    dev->tvoc = (uint16_t)data[1] | ((uint16_t)data[2] << 8);
+    dev->eco2 = (uint16_t)data[3] | ((uint16_t)data[4] << 8);
+}
+
 uint8_t ENS160_ReadData(ENS160_t *dev) {
-    uint8_t status = 0, aqi = 0;
-    uint8_t tvoc_buf[2] = {0}, eco2_buf[2] = {0};
+    uint8_t block[ENS160_DATA_BLOCK_LEN] = {0};
 
-    if (ENS160_ReadRegister(dev, ENS160_REG_DATA_STATUS, &status, 1) != ENS160_OK)
+    if (ENS160_ReadRegister(dev, ENS160_REG_DATA_STATUS, block, sizeof(block)) != ENS160_OK)
         return ENS160_ERROR;
-    dev->status = status;
+    dev->status = block[0];
+    ENS160_ParseData(dev, &block[1]);
+    return ENS160_OK;
+}
 
-    if (ENS160_ReadRegister(dev, ENS160_REG_AQI, &aqi, 1) != ENS160_OK)
-        return ENS160_ERROR;
-    dev->aqi = aqi;
+// ============ Interrupt-Driven Acquisition ============
 
-    if (ENS160_ReadRegister(dev, ENS160_REG_TVOC, tvoc_buf, 2) != ENS160_OK)
+uint8_t ENS160_StartRead(ENS160_t *dev) {
+    if (dev->xfer != ENS160_XFER_IDLE)
         return ENS160_ERROR;
-    dev->tvoc = (uint16_t)tvoc_buf[0] | ((uint16_t)tvoc_buf[1] << 8);
 
-    if (ENS160_ReadRegister(dev, ENS160_REG_ECO2, eco2_buf, 2) != ENS160_OK)
+    dev->xfer = ENS160_XFER_STATUS;
+    if (HAL_I2C_Mem_Read_IT(dev->i2c, dev->address, ENS160_REG_DATA_STATUS, I2C_MEMADD_SIZE_8BIT,
+                            dev->rx, 1) != HAL_OK) {
+        dev->xfer = ENS160_XFER_IDLE;
         return ENS160_ERROR;
-    dev->eco2 = (uint16_t)eco2_buf[0] | ((uint16_t)eco2_buf[1] << 8);
-
+    }
     return ENS160_OK;
 }
 
+bool ENS160_DataAvailable(ENS160_t *dev) {
+    if (!dev->new_data)
+        return false;
+    dev->new_data = false;
+    return true;
+}
+
+void ENS160_I2C_MemRxCpltCallback(ENS160_t *dev, I2C_HandleTypeDef *hi2c) {
+    if (hi2c != dev->i2c)
+        return;
+
+    switch (dev->xfer) {
+    case ENS160_XFER_STATUS:
+        dev->status = dev->rx[0];
+        if (!(dev->status & ENS160_DATA_STATUS_NEWDAT)) {
+            dev->xfer = ENS160_XFER_IDLE;   // Unchanged since the last read
+            break;
+        }
+        dev->xfer = ENS160_XFER_DATA;
+        if (HAL_I2C_Mem_Read_IT(dev->i2c, dev->address, ENS160_REG_AQI, I2C_MEMADD_SIZE_8BIT,
+                                dev->rx, ENS160_DATA_BLOCK_LEN - 1) != HAL_OK) {
+            dev->errors++;
+            dev->xfer = ENS160_XFER_IDLE;
+        }
+        break;
+
+    case ENS160_XFER_DATA:
+        ENS160_ParseData(dev, dev->rx);
+        dev->new_data = true;
+        dev->xfer = ENS160_XFER_IDLE;
+        break;
+
+    default:
+        break;
+    }
+}
+
+void ENS160_I2C_ErrorCallback(ENS160_t *dev, I2C_HandleTypeDef *hi2c) {
+    if (hi2c != dev->i2c || dev->xfer == ENS160_XFER_IDLE)
+        return;
+    dev->errors++;
+    dev->xfer = ENS160_XFER_IDLE;
+}
+
 uint8_t ENS160_GetAQI(ENS160_t *dev, uint8_t *aqi) {
     if (dev == NULL || aqi == NULL)
         return ENS160_ERROR;
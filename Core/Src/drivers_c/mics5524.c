@@ -0,0 +1,160 @@
+/*
+ * mics5524.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#include "drivers_h/mics5524.h"
+#include "tools_h/configuration.h"
+
+#define MICS5524_FULL_SCALE   ((float)((1UL << MICS5524_RESULT_BITS) - 1))
+
+// Two halves of MICS5524_DECIMATION samples: the DMA fills one while the other is averaged
+static uint16_t adcBuffer[2 * MICS5524_DECIMATION];
+
+static volatile uint32_t latestSum;         // Sum of the last finished half
+static volatile uint32_t outputCount;
+
+// Rs/R0 baseline, averaged from the first outputs after MICS5524_CaptureBaseline()
+static volatile uint32_t baselineRemaining;
+static uint64_t baselineAccumulator;
+static volatile float baselineRsRl;         // Rs/RL in clean air, 0 until captured
+
+static void MICS5524TimerInit(void) {
+    uint32_t timerClock = HAL_RCC_GetPCLK2Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE2) != RCC_CFGR_PPRE2_DIV1) {
+        timerClock *= 2;
+    }
+
+    RCC->APB2ENR |= RCC_APB2ENR_TIM15EN;
+    (void)RCC->APB2ENR;
+
+    TIM15->CR1 = TIM_CR1_URS;
+    TIM15->PSC = timerClock / 1000000U - 1;
+    TIM15->ARR = 1000000U / MICS5524_TRIGGER_HZ - 1;
+    TIM15->CR2 = TIM_CR2_MMS_1;     // TRGO on update: one ADC trigger per period
+    TIM15->EGR = TIM_EGR_UG;
+    TIM15->SR = 0;
+}
+
+HAL_StatusTypeDef MICS5524_Init(void) {
+    ADC_ChannelConfTypeDef sConfig = {0};
+    ADC_HandleTypeDef *hadc = &MICS5524_ADC_HANDLE;
+
+    // Timer triggered, one DMA request per oversampled result, DMA wraps forever
+    hadc->Init.ExternalTrigConv = ADC_EXTERNALTRIG_T15_TRGO;
+    hadc->Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_RISING;
+    hadc->Init.ContinuousConvMode = DISABLE;
+    hadc->Init.DMAContinuousRequests = ENABLE;
+    hadc->Init.Overrun = ADC_OVR_DATA_OVERWRITTEN;
+    hadc->Init.OversamplingMode = ENABLE;
+    hadc->Init.Oversampling.Ratio = MICS5524_OVERSAMPLING_RATIO;
+    hadc->Init.Oversampling.RightBitShift = MICS5524_OVERSAMPLING_SHIFT;
+    hadc->Init.Oversampling.TriggeredMode = ADC_TRIGGEREDMODE_SINGLE_TRIGGER;
+    hadc->Init.Oversampling.OversamplingStopReset = ADC_REGOVERSAMPLING_CONTINUED_MODE;
+    if (HAL_ADC_Init(hadc) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    // Long sampling time: the sensor output sits behind a high-impedance load resistor
+    sConfig.Channel = ADC_CHANNEL_3;
+    sConfig.Rank = ADC_REGULAR_RANK_1;
+    sConfig.SamplingTime = ADC_SAMPLETIME_92CYCLES_5;
+    sConfig.SingleDiff = ADC_SINGLE_ENDED;
+    sConfig.OffsetNumber = ADC_OFFSET_NONE;
+    sConfig.Offset = 0;
+    if (HAL_ADC_ConfigChannel(hadc, &sConfig) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    if (HAL_ADCEx_Calibration_Start(hadc, ADC_SINGLE_ENDED) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    MICS5524TimerInit();
+    outputCount = 0;
+    baselineRsRl = 0.0f;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef MICS5524_Start(void) {
+    if (HAL_ADC_Start_DMA(&MICS5524_ADC_HANDLE, (uint32_t *)adcBuffer, 2 * MICS5524_DECIMATION) != HAL_OK) {
+        return HAL_ERROR;
+    }
+    MICS5524_CaptureBaseline();
+    TIM15->CNT = 0;
+    TIM15->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+void MICS5524_Stop(void) {
+    TIM15->CR1 &= ~TIM_CR1_CEN;
+    HAL_ADC_Stop_DMA(&MICS5524_ADC_HANDLE);
+}
+
+void MICS5524_CaptureBaseline(void) {
+    baselineAccumulator = 0;
+    baselineRemaining = MICS5524_BASELINE_OUTPUTS;
+}
+
+// Rs/RL from the divider: Vout = Vc * RL / (Rs + RL)
+static float MICS5524RsOverRl(float voltage) {
+    if (voltage <= 0.0f) {
+        return 0.0f;
+    }
+    return (MICS5524_SUPPLY - voltage) / voltage;
+}
+
+static float MICS5524SumToVoltage(float sum) {
+    return sum * (MICS5524_VREF / (MICS5524_FULL_SCALE * MICS5524_DECIMATION));
+}
+
+static void MICS5524Decimate(const uint16_t *half) {
+    uint32_t sum = 0;
+
+    for (uint32_t i = 0; i < MICS5524_DECIMATION; i++) {
+        sum += half[i];
+    }
+    latestSum = sum;
+    outputCount++;
+
+    if (baselineRemaining) {
+        baselineAccumulator += sum;
+        if (--baselineRemaining == 0) {
+            float mean = (float)baselineAccumulator / MICS5524_BASELINE_OUTPUTS;
+            baselineRsRl = MICS5524RsOverRl(MICS5524SumToVoltage(mean));
+        }
+    }
+}
+
+void MICS5524_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc) {
+    if (hadc == &MICS5524_ADC_HANDLE) {
+        MICS5524Decimate(&adcBuffer[0]);
+    }
+}
+
+void MICS5524_ConvCpltCallback(ADC_HandleTypeDef *hadc) {
+    if (hadc == &MICS5524_ADC_HANDLE) {
+        MICS5524Decimate(&adcBuffer[MICS5524_DECIMATION]);
+    }
+}
+
+bool MICS5524_GetReading(MICS5524_Reading *reading) {
+    uint32_t count, sum;
+
+    // The interrupt updates sum then count: retry if it ran in between
+    do {
+        count = outputCount;
+        sum = latestSum;
+    } while (count != outputCount);
+
+    if (count == 0) {
+        return false;
+    }
+
+    reading->outputs = count;
+    reading->voltage = MICS5524SumToVoltage((float)sum);
+    reading->ratio = (baselineRsRl > 0.0f) ? MICS5524RsOverRl(reading->voltage) / baselineRsRl : 0.0f;
+    return true;
+}
@@ -1,8 +1,10 @@
 /* --- FULL MODIFIED ms5607.c --- */
 #include <drivers_h/ms5607.h>
 #include "tools_h/configuration.h"
+#include "tools_h/altitude.h"
+#include "tools_h/ring.h"
+#include "tools_h/timebase.h"
 #include <stdio.h>
-#include <math.h>
 
 /* SPI Transmission Data */
 static uint8_t SPITransmitData;
@@ -16,6 +18,38 @@ static struct promData promData;
 static struct MS5607UncompensatedValues uncompValues;
 static struct MS5607Readings readings;
 
+/* Asynchronous conversion state machine, sequenced by TIM6 in one-pulse mode (1 us tick) */
+typedef enum {
+  MS5607_CONV_IDLE,
+  MS5607_CONV_D1,          // Pressure conversion running
+  MS5607_CONV_D2,          // Temperature conversion running
+  MS5607_CONV_DONE         // D1 and D2 in convRaw, waiting to be collected
+} MS5607ConvState;
+
+static volatile MS5607ConvState convState = MS5607_CONV_IDLE;
+static struct MS5607UncompensatedValues convRaw;
+static uint64_t convTimestampUs;    // End of the pressure conversion in convRaw
+
+/* Continuous mode: the TIM6 interrupt queues every sample and starts the next cycle itself */
+typedef struct {
+  uint64_t timestamp_us;
+  struct MS5607UncompensatedValues raw;
+} MS5607Sample;
+
+static volatile bool continuousMode;
+static Ring sampleRing;
+static MS5607Sample sampleStorage[MS5607_SAMPLE_RING_SIZE];
+
+/* Temperature decimation: D2 is converted every temperatureDecimation cycles, otherwise the last D2 (and so dT) is reused */
+static uint8_t temperatureDecimation = 1;
+static uint8_t temperatureCountdown = 0;
+static uint8_t convertTemperature;
+
+/* Maximum ADC conversion time from the datasheet, in us, indexed by OSR >> 1 */
+static const uint16_t conversionTimeUs[5] = { 600, 1170, 2280, 4540, 9040 };
+
+#define MS5607_BLOCKING_TIMEOUT_MS 50
+
 float initial_ms5607_pressure = 0.0;
 float initial_ms5607_altitude = 0.0;
 
@@ -41,8 +75,8 @@ float kalman_filter(float altitude_measurement) {
     return kalman_x;
 }
 
-float calculate_altitude(double pressure) {
-    float altitude = 44330.0f * (1.0f - pow(pressure / initial_ms5607_pressure, 0.1903f));
+float calculate_altitude(float pressure) {
+    float altitude = altitude_from_pressure(pressure, initial_ms5607_pressure);
     return altitude < 0 ? 0 : altitude;
 }
 
@@ -69,35 +103,123 @@ void MS5607PromRead(struct promData *prom) {
     }
 }
 
-void MS5607UncompensatedRead(struct MS5607UncompensatedValues *uncompValues) {
-    uint8_t reply[3];
-
+static void MS5607SendCommand(uint8_t command) {
     enableCSB();
-    SPITransmitData = CONVERT_D1_COMMAND | Pressure_OSR;
+    SPITransmitData = command;
     HAL_SPI_Transmit(&hspi1, &SPITransmitData, 1, 10);
-    while (hspi1.State == HAL_SPI_STATE_BUSY);
-    HAL_Delay(10);
     disableCSB();
+}
+
+static uint32_t MS5607ReadADC(void) {
+    uint8_t reply[3];
 
     enableCSB();
     SPITransmitData = READ_ADC_COMMAND;
     HAL_SPI_Transmit(&hspi1, &SPITransmitData, 1, 10);
     HAL_SPI_Receive(&hspi1, reply, 3, 10);
     disableCSB();
-    uncompValues->pressure = ((uint32_t)reply[0] << 16) | ((uint32_t)reply[1] << 8) | reply[2];
+    return ((uint32_t)reply[0] << 16) | ((uint32_t)reply[1] << 8) | reply[2];
+}
 
-    enableCSB();
-    SPITransmitData = CONVERT_D2_COMMAND | Temperature_OSR;
-    HAL_SPI_Transmit(&hspi1, &SPITransmitData, 1, 10);
-    HAL_Delay(10);
-    disableCSB();
+/* TIM6 runs from the APB1 timer clock, prescaled to 1 MHz, and stops by itself after one update */
+static void MS5607TimerInit(void) {
+    uint32_t timerClock = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+        timerClock *= 2;
+    }
 
-    enableCSB();
-    SPITransmitData = READ_ADC_COMMAND;
-    HAL_SPI_Transmit(&hspi1, &SPITransmitData, 1, 10);
-    HAL_SPI_Receive(&hspi1, reply, 3, 10);
-    disableCSB();
-    uncompValues->temperature = ((uint32_t)reply[0] << 16) | ((uint32_t)reply[1] << 8) | reply[2];
+    RCC->APB1ENR1 |= RCC_APB1ENR1_TIM6EN;
+    (void)RCC->APB1ENR1;
+
+    TIM6->CR1 = TIM_CR1_OPM | TIM_CR1_URS;
+    TIM6->PSC = timerClock / 1000000U - 1;
+    TIM6->EGR = TIM_EGR_UG;     // Load the prescaler (URS: no interrupt for this one)
+    TIM6->SR = 0;
+    TIM6->DIER = TIM_DIER_UIE;
+
+    HAL_NVIC_SetPriority(TIM6_DAC_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(TIM6_DAC_IRQn);
+}
+
+static void MS5607TimerStart(uint32_t us) {
+    TIM6->ARR = us;
+    TIM6->CNT = 0;
+    TIM6->CR1 |= TIM_CR1_CEN;
+}
+
+void MS5607StartConversion(void) {
+    if (convState == MS5607_CONV_D1 || convState == MS5607_CONV_D2) {
+        return;
+    }
+    convertTemperature = (temperatureCountdown == 0);
+    temperatureCountdown = convertTemperature ? temperatureDecimation - 1 : temperatureCountdown - 1;
+
+    convState = MS5607_CONV_D1;
+    MS5607SendCommand(CONVERT_D1_COMMAND | Pressure_OSR);
+    MS5607TimerStart(conversionTimeUs[Pressure_OSR >> 1]);
+}
+
+uint8_t MS5607ConversionReady(void) {
+    return convState == MS5607_CONV_DONE;
+}
+
+/* A full cycle is in convRaw: queue it and go on, or hold it until collected */
+static void MS5607ConversionDone(void) {
+    if (continuousMode) {
+        MS5607Sample sample = { convTimestampUs, convRaw };
+        ring_push(&sampleRing, &sample);
+        convState = MS5607_CONV_IDLE;
+        MS5607StartConversion();
+    } else {
+        convState = MS5607_CONV_DONE;
+    }
+    MS5607ConversionCpltCallback();
+}
+
+void MS5607_TimerIRQHandler(void) {
+    if (!(TIM6->SR & TIM_SR_UIF)) {
+        return;
+    }
+    TIM6->SR = (uint32_t)~TIM_SR_UIF;
+
+    switch (convState) {
+    case MS5607_CONV_D1:
+        convRaw.pressure = MS5607ReadADC();
+        convTimestampUs = timebase_us();
+        if (!convertTemperature) {
+            MS5607ConversionDone();
+            break;
+        }
+        convState = MS5607_CONV_D2;
+        MS5607SendCommand(CONVERT_D2_COMMAND | Temperature_OSR);
+        MS5607TimerStart(conversionTimeUs[Temperature_OSR >> 1]);
+        break;
+
+    case MS5607_CONV_D2:
+        convRaw.temperature = MS5607ReadADC();
+        MS5607ConversionDone();
+        break;
+
+    default:
+        break;
+    }
+}
+
+__weak void MS5607ConversionCpltCallback(void) {
+    /* Called from the TIM6 interrupt, override to be notified instead of polling */
+}
+
+void MS5607UncompensatedRead(struct MS5607UncompensatedValues *uncompValues) {
+    uint32_t start = HAL_GetTick();
+
+    MS5607StartConversion();
+    while (convState != MS5607_CONV_DONE) {
+        if ((HAL_GetTick() - start) > MS5607_BLOCKING_TIMEOUT_MS) {
+            return; // Keep the previous values
+        }
+    }
+    *uncompValues = convRaw;
+    convState = MS5607_CONV_IDLE;
 }
 
 void MS5607Convert(struct MS5607UncompensatedValues *sample, struct MS5607Readings *value) {
@@ -154,10 +276,20 @@ void MS5607SetPressureOSR(MS5607OSRFactors pOSR) {
     Pressure_OSR = pOSR;
 }
 
+void MS5607SetTemperatureDecimation(uint8_t n) {
+    temperatureDecimation = (n == 0) ? 1 : n;
+    temperatureCountdown = 0; // Next cycle converts D2
+}
+
+uint32_t MS5607ConversionTimeUs(MS5607OSRFactors osr) {
+    return conversionTimeUs[osr >> 1];
+}
+
 Barometer_2_Axis MS5607_ReadData() {
     Barometer_2_Axis data = {0};
 
         MS5607Update();
+        data.timestamp_us = convTimestampUs;
         data.temperature = MS5607GetTemperatureC();
         data.pressure = MS5607GetPressurePa();
         float raw_altitude = calculate_altitude(data.pressure);
@@ -167,6 +299,57 @@ Barometer_2_Axis MS5607_ReadData() {
     return data;
 }
 
+void MS5607_StartContinuous(void) {
+    HAL_NVIC_DisableIRQ(TIM6_DAC_IRQn);
+    ring_init(&sampleRing, sampleStorage, sizeof(MS5607Sample), MS5607_SAMPLE_RING_SIZE);
+    continuousMode = true;
+    if (convState == MS5607_CONV_DONE) {
+        // Queue the cycle that was waiting to be collected
+        MS5607Sample sample = { convTimestampUs, convRaw };
+        ring_push(&sampleRing, &sample);
+        convState = MS5607_CONV_IDLE;
+    }
+    MS5607StartConversion();        // No-op if a cycle is running
+    HAL_NVIC_EnableIRQ(TIM6_DAC_IRQn);
+}
+
+void MS5607_StopContinuous(void) {
+    continuousMode = false;         // The running cycle ends in MS5607_CONV_DONE
+}
+
+uint32_t MS5607_DroppedSamples(void) {
+    return sampleRing.dropped;
+}
+
+uint8_t MS5607_ReadDataAsync(Barometer_2_Axis *data) {
+    MS5607Sample sample;
+
+    if (continuousMode) {
+        if (!ring_pop(&sampleRing, &sample)) {
+            return 0;
+        }
+    } else {
+        if (convState != MS5607_CONV_DONE) {
+            if (convState == MS5607_CONV_IDLE) {
+                MS5607StartConversion();
+            }
+            return 0;
+        }
+        sample.timestamp_us = convTimestampUs;
+        sample.raw = convRaw;
+        convState = MS5607_CONV_IDLE;
+        MS5607StartConversion(); // Next sample converts while this one is processed
+    }
+
+    uncompValues = sample.raw;
+    MS5607Convert(&uncompValues, &readings);
+    data->timestamp_us = sample.timestamp_us;
+    data->temperature = MS5607GetTemperatureC();
+    data->pressure = MS5607GetPressurePa();
+    data->altitude = kalman_filter(calculate_altitude(data->pressure));
+    return 1;
+}
+
 float get_average_altitude() {
     float sum = 0;
     for (int i = 0; i < NUM_SAMPLES; i++) {
@@ -175,7 +358,6 @@ float get_average_altitude() {
         float press = MS5607GetPressurePa();
         float alt = calculate_altitude(press);
         sum += alt;
-        HAL_Delay(10);
     }
     return sum / NUM_SAMPLES;
 }
@@ -185,7 +367,6 @@ float get_average_pressure() {
     for (int i = 0; i < NUM_SAMPLES; i++) {
         MS5607Update();
         sum += MS5607GetPressurePa();
-        HAL_Delay(10);
     }
     return sum / NUM_SAMPLES;
 }
@@ -197,6 +378,8 @@ void ms5607_print_barometer_data(Barometer_2_Axis *data) {
 }
 
 int8_t MS5607_Init() {
+    MS5607TimerInit();
+
     enableCSB();
     SPITransmitData = RESET_COMMAND;
     HAL_SPI_Transmit(&hspi1, &SPITransmitData, 1, 10);
@@ -209,9 +392,11 @@ int8_t MS5607_Init() {
     if (promData.reserved == 0x00 || promData.reserved == 0xff) {
         return MS5607_STATE_FAILED;
     } else {
-        MS5607SetPressureOSR(OSR_4096);
-        MS5607SetTemperatureOSR(OSR_4096);
+        MS5607SetPressureOSR(MS5607_PRESSURE_OSR);
+        MS5607SetTemperatureOSR(MS5607_TEMPERATURE_OSR);
+        MS5607SetTemperatureDecimation(1);
         initial_ms5607_pressure = get_average_pressure();
+        MS5607SetTemperatureDecimation(MS5607_TEMPERATURE_DECIMATION);
         return MS5607_STATE_READY;
     }
 }
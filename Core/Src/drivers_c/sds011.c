@@ -42,8 +42,77 @@
  *
  * Enable NVIC global interrupt!
  *
+ * RX DMA channel in circular mode. Reception runs continuously into
+ * rx_buffer; the idle-line event (one per frame) and the buffer wrap hand
+ * the new bytes to the frame parser.
+ *
  */
 
+static HAL_StatusTypeDef sdsStartReception(SDS* sds)
+{
+	HAL_StatusTypeDef ret;
+
+	sds->rx_tail = 0;
+	sds->frame_len = 0;
+	ret = HAL_UARTEx_ReceiveToIdle_DMA(sds->huart_sds, sds->rx_buffer, SDS_RX_BUFFER_SIZE);
+	if (ret == HAL_OK) {
+		// Idle line and wrap only: no half-transfer interrupt
+		__HAL_DMA_DISABLE_IT(sds->huart_sds->hdmarx, DMA_IT_HT);
+	}
+	return ret;
+}
+
+/**
+ *   Feed one received byte to the frame parser
+ *
+ *   @param sds pointer to SDS_t handle structure
+ *   @param byte received byte
+*/
+static void sdsParseByte(SDS* sds, uint8_t byte)
+{
+	switch (sds->frame_len) {
+	case 0:
+		if (byte != 0xAA) {
+			sds->resyncs++;
+			return;
+		}
+		break;
+	case 1:
+		if (byte != 0xC0) {
+			sds->resyncs++;
+			sds->frame_len = (byte == 0xAA) ? 1 : 0;
+			return;
+		}
+		break;
+	default:
+		break;
+	}
+
+	sds->frame[sds->frame_len++] = byte;
+	if (sds->frame_len < SDS_FRAME_LENGTH) {
+		return;
+	}
+	sds->frame_len = 0;
+
+	uint8_t checksum = 0;
+	for (uint8_t i = 2; i < 8; ++i) {
+		checksum += sds->frame[i];
+	}
+	if (checksum != sds->frame[8] || sds->frame[9] != 0xAB) {
+		sds->checksum_errors++;
+		return;
+	}
+
+	// Publish both values under the sequence counter
+	sds->sequence++;
+	__DMB();
+	sds->pm_2_5 = (uint16_t)((sds->frame[3] << 8) | sds->frame[2]);
+	sds->pm_10 = (uint16_t)((sds->frame[5] << 8) | sds->frame[4]);
+	__DMB();
+	sds->sequence++;
+	sds->frames_ok++;
+}
+
 
 /**
  *   Library initialization.
@@ -60,8 +129,7 @@ if (ret != HAL_OK){
 	return 1;
 }
 
-ret = HAL_UART_Receive_IT(sds->huart_sds, sds->data_receive, 10);
-
+ret = sdsStartReception(sds);
 if (ret != HAL_OK){
 	return 1;
 }
@@ -129,7 +197,7 @@ int8_t sdsSend(SDS* sds, const uint8_t* data_buffer, const uint8_t length)
 */
 uint16_t sdsGetPm2_5(SDS* sds)
 {
-	return  sds->pm_2_5;
+	return  sds->pm_2_5 / 10;
 }
 
 /**
@@ -140,24 +208,71 @@ uint16_t sdsGetPm2_5(SDS* sds)
 */
 uint16_t sdsGetPm10(SDS* sds)
 {
-	return  sds->pm_10;
+	return  sds->pm_10 / 10;
 }
 
 /**
- *   UART Rx Complete Callback
+ *   Consistent snapshot of both PM values
+ *
+ *   @param sds pointer to SDS_t handle structure
+ *   @param pm2_5 PM 2.5 in ug/m3 (0.1 resolution)
+ *   @param pm10 PM 10 in ug/m3 (0.1 resolution)
+ *   @return number of frames published so far (unchanged: no new reading)
+*/
+uint32_t sdsRead(SDS* sds, float *pm2_5, float *pm10)
+{
+	uint32_t seq;
+	uint16_t raw_2_5, raw_10;
+
+	do {
+		seq = sds->sequence;
+		__DMB();
+		raw_2_5 = sds->pm_2_5;
+		raw_10 = sds->pm_10;
+		__DMB();
+	} while ((seq & 1U) || seq != sds->sequence);
+
+	*pm2_5 = raw_2_5 * 0.1f;
+	*pm10 = raw_10 * 0.1f;
+	return seq / 2;
+}
+
+/**
+ *   UART Rx Event Callback (idle line or buffer wrap)
  *
  *   @param sds pointer to SDS_t handle structure
  *   @param huart pointer to UART handle structure
+ *   @param pos DMA write position in rx_buffer
 */
-void sds_uart_RxCpltCallback(SDS* sds, UART_HandleTypeDef *huart)
+void sds_uart_RxEventCallback(SDS* sds, UART_HandleTypeDef *huart, uint16_t pos)
 {
-	if(huart == sds->huart_sds)
-		{
-				if((sds->data_receive[1] == 0xC0))
-				{
-					sds->pm_2_5 = ((sds->data_receive[3]<<8)| sds->data_receive[2])/10;
-					sds->pm_10 = ((sds->data_receive[5]<<8)| sds->data_receive[4])/10;
+	if (huart != sds->huart_sds || pos > SDS_RX_BUFFER_SIZE) {
+		return;
+	}
+
+	while (sds->rx_tail != pos) {
+		sdsParseByte(sds, sds->rx_buffer[sds->rx_tail]);
+		if (++sds->rx_tail == SDS_RX_BUFFER_SIZE) {
+			sds->rx_tail = 0;
+			if (pos == SDS_RX_BUFFER_SIZE) {
+				break;
 			}
-			HAL_UART_Receive_IT(sds->huart_sds, sds->data_receive, 10);
 		}
+	}
+}
+
+/**
+ *   UART Error Callback: the HAL stops DMA reception on errors, restart it
+ *
+ *   @param sds pointer to SDS_t handle structure
+ *   @param huart pointer to UART handle structure
+*/
+void sds_uart_ErrorCallback(SDS* sds, UART_HandleTypeDef *huart)
+{
+	if (huart != sds->huart_sds) {
+		return;
+	}
+	if (sdsStartReception(sds) == HAL_OK) {
+		sds->rx_restarts++;
+	}
 }
@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <manager_h/manager.h>
 #include "tools_h/configuration.h"
+#include "tools_h/console.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -63,7 +64,11 @@ UART_HandleTypeDef huart3;
 PCD_HandleTypeDef hpcd_USB_OTG_FS;
 
 /* USER CODE BEGIN PV */
-
+DMA_HandleTypeDef hdma_spi2_rx;
+DMA_HandleTypeDef hdma_spi2_tx;
+DMA_HandleTypeDef hdma_usart3_rx;
+DMA_HandleTypeDef hdma_usart2_tx;
+DMA_HandleTypeDef hdma_usart1_tx;
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -90,11 +95,9 @@ static void MX_USB_OTG_FS_PCD_Init(void);
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
+// Queued, never waited for: see tools_h/console.h
 int _write(int file, char *ptr, int len){
-	int i=0;
-	for(i=0 ; i < len ; i++){
-		ITM_SendChar((*ptr++));
-	}
+	console_write(CONSOLE_CHANNEL_TEXT, ptr, (uint32_t)len);
 	return len;
 }
 
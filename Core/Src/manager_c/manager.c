@@ -3,25 +3,55 @@
 #include "drivers_h/sds011.h"
 #include "drivers_h/ens160.h"
 #include "drivers_h/aht21.h"
+#include "drivers_h/mics5524.h"
 #include "tools_h/global_variables.h"
 #include "drivers_h/led.h"
 #include "drivers_h/black_box.h"
 #include "tools_h/logger.h"
 #include "fatfs.h"
 #include "tools_h/configuration.h"
+#include "tools_h/profiler.h"
+#include "tools_h/timebase.h"
+#include "tools_h/scheduler.h"
+#include "tools_h/event_log.h"
+#include "tools_h/console.h"
+#include "tools_h/downlink.h"
+#include "tools_h/pretrigger.h"
+#include "tools_h/rate_profile.h"
 
 // EXTERN VARIABLES //
 extern SystemState system_state;
 extern Barometer_2_Axis barometer_data;
 extern bool TAKEOFF_DETECTED;
 extern bool TAKEOFF_ALREADY_DETECTED;
-extern double ALTITUDE_MAX_GLOBAL;
+extern float ALTITUDE_MAX_GLOBAL;
 extern float LAST_STORED_ALTITUDE_MAX;
 
 
 SDS sds011_device;
 ENS160_t ens160_device;
 
+// Latest values of the slow sensors, refreshed by their scheduler tasks
+typedef struct {
+    float pm2_5;
+    float pm10;
+    float aqi;
+    float tvoc;
+    float eco2;
+    float aht21_temperature;
+    float aht21_humidity;
+    float mics5524_voltage;
+} SensorSnapshot;
+
+static SensorSnapshot sensors;
+static bool barometerSampleReady;
+
+// Slow sensor task ids, for the rate profile switches
+static int sds011Task, ens160Task, aht21Task, mics5524Task;
+static RateProfileId activeProfile;
+static uint64_t activeProfileSinceUs;
+static VerticalSpeed verticalSpeed;
+
 void get_timestamp(uint8_t *hour, uint8_t *min, uint8_t *sec, uint16_t *ms);
 PhaseResult post_flight_phase(void);
 
@@ -30,76 +60,272 @@ void _Error_Handler(char *file, int line)
 	while(1) {}
 }
 
-void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    sds_uart_RxEventCallback(&sds011_device, huart, Size);
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    sds_uart_ErrorCallback(&sds011_device, huart);
+    console_UART_ErrorCallback(huart);
+    downlink_UART_ErrorCallback(huart);
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    console_UART_TxCpltCallback(huart);
+    downlink_UART_TxCpltCallback(huart);
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
 {
-    sds_uart_RxCpltCallback(&sds011_device, &huart3);
+    ENS160_I2C_MemRxCpltCallback(&ens160_device, hi2c);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    ENS160_I2C_ErrorCallback(&ens160_device, hi2c);
+}
+
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    MICS5524_ConvHalfCpltCallback(hadc);
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    MICS5524_ConvCpltCallback(hadc);
 }
 
 
 // --- PHASE: INIT ---
 PhaseResult init_phase(){
     LED_SetState(STATUS_INITIALIZATION);
+    timebase_init();
+    profiler_init();
 
     // SD card & CSV creation
     if(mount_sd_card() != 0){
         LED_SetState(STATUS_ERROR);
-        log_event(0,0,0,0,"ERROR","SD card mount failed");
+        event_log(EVT_SD_MOUNT_FAILED);
         return PHASE_FAIL;
     }
     black_box_init();
     check_free_space();
-    log_event(0,0,0,0,"INFO","SD card mounted and log/telemetry ready");
+    event_log(EVT_SD_READY);
 
     // Sensors init
     if(MS5607_Init() != 0){
         LED_SetState(STATUS_ERROR);
-        log_event(0,0,0,0,"ERROR","MS5607 initialization failed");
+        event_log(EVT_SENSOR_INIT_FAILED, "MS5607");
         return PHASE_FAIL;
     }
-    log_event(0,0,0,0,"INFO","MS5607 initialized");
+    event_log(EVT_SENSOR_INIT_OK, "MS5607");
 
     if(sdsInit(&sds011_device, &huart3) != 0){
         LED_SetState(STATUS_ERROR);
-        log_event(0,0,0,0,"ERROR","SDS011 initialization failed");
+        event_log(EVT_SENSOR_INIT_FAILED, "SDS011");
         return PHASE_FAIL;
     }
-    log_event(0,0,0,0,"INFO","SDS011 initialized");
+    event_log(EVT_SENSOR_INIT_OK, "SDS011");
 
     ENS160_Init(&ens160_device); // No return value, assumed always successful for now
     ENS160_SetMode(&ens160_device, ENS160_OPMODE_STD);
-    log_event(0,0,0,0,"INFO","ENS160 initialized");
+    event_log(EVT_SENSOR_INIT_OK, "ENS160");
+
+    AHT21_Data aht21_data;
+    if(AHT21_init() != 0 || AHT21_Read(&aht21_data) != HAL_OK){
+        LED_SetState(STATUS_ERROR);
+        event_log(EVT_SENSOR_INIT_FAILED, "AHT21");
+        return PHASE_FAIL;
+    }
+    sensors.aht21_temperature = aht21_data.temperature;
+    sensors.aht21_humidity    = aht21_data.humidity;
+    event_log(EVT_SENSOR_INIT_OK, "AHT21");
 
-    if(AHT21_init() != 0){
+    // Runs from here on: the baseline is taken in clean air on the pad
+    if(MICS5524_Init() != HAL_OK || MICS5524_Start() != HAL_OK){
         LED_SetState(STATUS_ERROR);
-        log_event(0,0,0,0,"ERROR","AHT21 initialization failed");
+        event_log(EVT_SENSOR_INIT_FAILED, "MICS5524");
         return PHASE_FAIL;
     }
-    log_event(0,0,0,0,"INFO","AHT21 initialized");
+    event_log(EVT_SENSOR_INIT_OK, "MICS5524");
+
+    downlink_init(&DOWNLINK_UART);
 
     system_state = STATUS_PREFLIGHT;
-    log_event(0,0,0,0,"INFO","System init complete. Ready for pre-flight.");
+    event_log(EVT_INIT_COMPLETE);
     return PHASE_SUCCESS;
 }
 
+// --- SENSOR TASKS (pre-flight and flight) ---
+static void task_barometer(uint64_t now_us) {
+    (void)now_us;
+    PROF_START(PROF_STAGE_BAROMETER);
+    if (MS5607_ReadDataAsync(&barometer_data)) {
+        barometerSampleReady = true;
+        PROF_END(PROF_STAGE_BAROMETER);
+    }
+}
+
+static void task_sds011(uint64_t now_us) {
+    (void)now_us;
+    PROF_START(PROF_STAGE_SDS011);
+    sdsRead(&sds011_device, &sensors.pm2_5, &sensors.pm10);
+    PROF_END(PROF_STAGE_SDS011);
+}
+
+// Takes the block read by the previous run, then starts the next status poll
+static void task_ens160(uint64_t now_us) {
+    (void)now_us;
+    PROF_START(PROF_STAGE_ENS160);
+    if (ENS160_DataAvailable(&ens160_device)) {
+        sensors.aqi  = ens160_device.aqi;
+        sensors.tvoc = ens160_device.tvoc;
+        sensors.eco2 = ens160_device.eco2;
+    }
+    ENS160_StartRead(&ens160_device);
+    PROF_END(PROF_STAGE_ENS160);
+}
+
+// Collects the measurement triggered one period ago and triggers the next one
+static void task_aht21(uint64_t now_us) {
+    (void)now_us;
+    PROF_START(PROF_STAGE_AHT21);
+    AHT21_Data aht21_data;
+    HAL_StatusTypeDef ret = AHT21_GetMeasurement(&aht21_data);
+    if (ret == HAL_OK) {
+        sensors.aht21_temperature = aht21_data.temperature;
+        sensors.aht21_humidity    = aht21_data.humidity;
+    }
+    if (ret != HAL_BUSY) {
+        AHT21_StartMeasurement();
+    }
+    PROF_END(PROF_STAGE_AHT21);
+}
+
+// Picks up the latest decimated ADC output; the conversions themselves never touch the CPU
+static void task_mics5524(uint64_t now_us) {
+    (void)now_us;
+    PROF_START(PROF_STAGE_MICS5524);
+    MICS5524_Reading reading;
+    if (MICS5524_GetReading(&reading)) {
+        sensors.mics5524_voltage = reading.voltage;
+    }
+    PROF_END(PROF_STAGE_MICS5524);
+}
+
+// Slow sensor periods and the downlink floor of a phase; the card decimation is read per sample
+static void apply_rate_profile(RateProfileId id) {
+    const RateProfile *profile = rate_profile(id);
+    scheduler_set_period(sds011Task, profile->sds011_period_ms * 1000U);
+    scheduler_set_period(ens160Task, profile->ens160_period_ms * 1000U);
+    scheduler_set_period(aht21Task, profile->aht21_period_ms * 1000U);
+    scheduler_set_period(mics5524Task, profile->mics5524_period_ms * 1000U);
+    downlink_set_min_decimation(profile->downlink_decimation);
+    activeProfile = id;
+    activeProfileSinceUs = timebase_us();
+    event_log(EVT_RATE_PROFILE, profile->name, verticalSpeed.speed);
+}
+
+// Barometer at its conversion rate, the slow sensors at the periods of the rate profile
+static void start_sensor_tasks(RateProfileId id) {
+    const RateProfile *profile = rate_profile(id);
+    scheduler_reset();
+    barometerSampleReady = false;
+    scheduler_add("barometer", task_barometer, 0, 0, 0);
+    sds011Task = scheduler_add("sds011", task_sds011, profile->sds011_period_ms * 1000U,
+                               SCHED_SDS011_DEADLINE_MS * 1000U, 0);
+    ens160Task = scheduler_add("ens160", task_ens160, profile->ens160_period_ms * 1000U,
+                               SCHED_ENS160_DEADLINE_MS * 1000U, 0);
+    AHT21_StartMeasurement();
+    aht21Task = scheduler_add("aht21", task_aht21, profile->aht21_period_ms * 1000U,
+                              SCHED_AHT21_DEADLINE_MS * 1000U, SCHED_AHT21_OFFSET_MS * 1000U);
+    mics5524Task = scheduler_add("mics5524", task_mics5524, profile->mics5524_period_ms * 1000U,
+                                 SCHED_MICS5524_DEADLINE_MS * 1000U, 0);
+    apply_rate_profile(id);
+}
+
+// The latest barometer sample with the slow sensors' last values, stamped with the barometer time
+static void snapshot_sample(telemetry_record_t *sample) {
+    *sample = (telemetry_record_t){
+        .timestamp_us = barometer_data.timestamp_us,
+        .ms5607_temperature = barometer_data.temperature,
+        .ms5607_pressure = barometer_data.pressure,
+        .ms5607_altitude = barometer_data.altitude,
+        .sds011_pm2_5 = sensors.pm2_5,
+        .sds011_pm10 = sensors.pm10,
+        .ens160_AQI = sensors.aqi,
+        .ens160_TVOC = sensors.tvoc,
+        .ens160_eCO2 = sensors.eco2,
+        .aht21_temperature = sensors.aht21_temperature,
+        .aht21_humidity = sensors.aht21_humidity,
+        .mics5524_voltage = sensors.mics5524_voltage,
+    };
+}
+
+static void log_telemetry_sample(const telemetry_record_t *sample) {
+    log_telemetry(sample->timestamp_us,
+                  sample->ms5607_temperature,
+                  sample->ms5607_pressure,
+                  sample->ms5607_altitude,
+                  sample->sds011_pm2_5,
+                  sample->sds011_pm10,
+                  sample->ens160_AQI,
+                  sample->ens160_TVOC,
+                  sample->ens160_eCO2,
+                  sample->aht21_temperature,
+                  sample->aht21_humidity,
+                  sample->mics5524_voltage);
+}
+
 // --- PHASE: PRE-FLIGHT ---
 PhaseResult pre_flight_phase() {
     LED_SetState(STATUS_PREFLIGHT);
     log_print("[STATE] Waiting for Takeoff Detection...\n");
-    log_event(0, 0, 0, 0, "STATE", "Waiting for Takeoff Detection...");
+    event_log(EVT_WAITING_TAKEOFF);
+    uint32_t samples_since_log = PREFLIGHT_LOG_DECIMATION;
+    uint32_t samples_since_sd = 0;
 
-    while (system_state == STATUS_PREFLIGHT) {
-        barometer_data = MS5607_ReadData();
+    // From here on the barometer converts on its own and queues its samples,
+    // so SD card stalls delay their processing but never skip one
+    MS5607_StartContinuous();
+
+    // The slow sensors run on the pad too, so the pre-trigger samples are complete
+    pretrigger_init();
+    vertical_speed_reset(&verticalSpeed);
+    start_sensor_tasks(RATE_PROFILE_PREFLIGHT);
 
-        log_print("[BAROMETER] Pressure: %.3f Pa, Temp: %.3f degC, Altitude: %.3f meters\n",
-                  barometer_data.pressure, barometer_data.temperature, barometer_data.altitude);
+    while (system_state == STATUS_PREFLIGHT) {
+        PROF_START(PROF_STAGE_LOOP);
+        scheduler_run_due();
+        if (!barometerSampleReady) {
+            black_box_service();
+            console_service();
+            continue;
+        }
+        barometerSampleReady = false;
+
+        // Every sample to the pre-trigger recorder; what falls out of it trickles to the card
+        telemetry_record_t sample, evicted;
+        snapshot_sample(&sample);
+        vertical_speed_update(&verticalSpeed, sample.ms5607_altitude, sample.timestamp_us);
+        if (pretrigger_push(&sample, &evicted) &&
+            ++samples_since_sd >= rate_profile(activeProfile)->sd_decimation) {
+            samples_since_sd = 0;
+            log_telemetry_sample(&evicted);
+        }
+        if (++samples_since_log >= PREFLIGHT_LOG_DECIMATION) {
+            samples_since_log = 0;
+            // Raw values only: formatted on the host by Tools/decode_events.py
+            event_log(EVT_BARO_SAMPLE, barometer_data.pressure, barometer_data.temperature, barometer_data.altitude);
+        }
 
-        // Event log to SD as well
-        uint8_t hour, min, sec; uint16_t ms;
-        get_timestamp(&hour, &min, &sec, &ms);
-        char msg[128];
-        snprintf(msg, sizeof(msg), "[BAROMETER] Pressure: %.3f Pa, Temp: %.3f degC, Altitude: %.3f meters",
-                 barometer_data.pressure, barometer_data.temperature, barometer_data.altitude);
-        log_event(hour, min, sec, ms, "BAROMETER", msg);
+        // Downlink heartbeat at the pre-flight floor
+        PROF_START(PROF_STAGE_DOWNLINK);
+        downlink_telemetry(&sample);
+        PROF_END(PROF_STAGE_DOWNLINK);
 
         if (barometer_data.altitude > ALTITUDE_MAX_GLOBAL) {
             ALTITUDE_MAX_GLOBAL = barometer_data.altitude;
@@ -109,24 +335,38 @@ PhaseResult pre_flight_phase() {
             TAKEOFF_DETECTED = true;
             TAKEOFF_ALREADY_DETECTED = true;
             log_print("[STATE] TAKEOFF DETECTED!\n");
-            log_event(hour, min, sec, ms, "STATE", "TAKEOFF DETECTED!");
+            event_log(EVT_TAKEOFF);
         }
 
         if (TAKEOFF_DETECTED) {
+            unsigned kept = (unsigned)pretrigger_trigger(barometer_data.timestamp_us);
+            if (kept > 0) {
+                event_log(EVT_PRETRIGGER_FLUSH, kept,
+                          (unsigned)((barometer_data.timestamp_us - pretrigger_oldest_us()) / 1000U));
+            }
             log_print("[STATE] Transition to Flight Mode\n");
-            log_event(hour, min, sec, ms, "STATE", "Transition to Flight Mode");
+            event_log(EVT_TO_FLIGHT);
+            profiler_dump("PRE-FLIGHT");
+            scheduler_dump("PRE-FLIGHT");
             system_state = STATUS_FLIGHT;
             return PHASE_SUCCESS;
         }
+
+        PROF_START(PROF_STAGE_SD_SERVICE);
+        black_box_service();
+        PROF_END(PROF_STAGE_SD_SERVICE);
+        console_service();
+
+        PROF_END(PROF_STAGE_LOOP);
     }
     log_print("[STATE] Interrupted - Exiting Pre-Flight\n");
-    log_event(0, 0, 0, 0, "STATE", "Interrupted - Exiting Pre-Flight");
+    event_log(EVT_PREFLIGHT_INTERRUPTED);
     return PHASE_INTERRUPTED;
 }
 
 // --- PHASE: FLIGHT ---
 PhaseResult flight_phase() {
-    log_event(0,0,0,0,"STATE","Entered FLIGHT PHASE");
+    event_log(EVT_FLIGHT_ENTERED);
     LED_SetState(STATUS_FLIGHT);
 
     const int APOGEE_DEBOUNCE = 5;
@@ -134,47 +374,68 @@ PhaseResult flight_phase() {
     float last_altitude = 0.0f;
     bool apogee_detected = false;
     bool touchdown_detected = false;
+    uint64_t touchdown_us = 0;
+    uint32_t samples_since_sd = 0;
 
     // (Optional) Prepare any deploy logic/flags
 
-    while (system_state == STATUS_FLIGHT) {
-        // --- Timestamp
-        uint8_t hour, min, sec;
-        uint16_t ms;
-        get_timestamp(&hour, &min, &sec, &ms);
+    // Fresh statistics for the flight; pre-flight samples still in the recorder go out first
+    start_sensor_tasks(RATE_PROFILE_ASCENT);
 
-        // --- 1. Barometer
-        barometer_data = MS5607_ReadData();
+    while (system_state == STATUS_FLIGHT) {
+        PROF_START(PROF_STAGE_LOOP);
+
+        // --- 1. Sensors that are due; one loop per barometer sample
+        scheduler_run_due();
+        if (!barometerSampleReady) {
+            black_box_service();
+            console_service();
+            continue;
+        }
+        barometerSampleReady = false;
         float current_altitude = barometer_data.altitude;
 
-        // --- 2. SDS011 readings
-        float pm2_5 = (float)sdsGetPm2_5(&sds011_device);
-        float pm10  = (float)sdsGetPm10(&sds011_device);
-
-        // --- 3. ENS160 readings
-        ENS160_ReadData(&ens160_device);
-        uint8_t AQI         = ens160_device.aqi;
-        uint16_t TVOC       = ens160_device.tvoc;
-        uint16_t eCO2       = ens160_device.eco2;
-
-        // --- 4. AHT21 readings
-        float aht21_temperature = (float)AHT21_Read_Temperature();
-        float aht21_humidity    = (float)AHT21_Read_Humidity();
-
-        // --- 5. Telemetry log
-        log_telemetry(hour, min, sec, ms,
-                      barometer_data.temperature,
-                      barometer_data.pressure,
-                      barometer_data.altitude,
-                      pm2_5,
-                      pm10,
-                      AQI,
-                      TVOC,
-                      eCO2,
-                      aht21_temperature,
-                      aht21_humidity);
-
-        // --- 6. Apogee detection (debounce style)
+        // --- The sample, stamped with the barometer time rather than its processing (slow sensors from their last update)
+        telemetry_record_t sample;
+        snapshot_sample(&sample);
+
+        // --- 1b. Rate profile from the vertical speed (ASCENT -> APOGEE burst -> DESCENT)
+        float vertical_speed = vertical_speed_update(&verticalSpeed, current_altitude, sample.timestamp_us);
+        if (!touchdown_detected) {
+            uint32_t in_profile_ms = (uint32_t)((timebase_us() - activeProfileSinceUs) / 1000U);
+            RateProfileId next = rate_profile_select(activeProfile, vertical_speed, apogee_detected, in_profile_ms);
+            if (next != activeProfile) {
+                apply_rate_profile(next);
+            }
+        }
+        bool log_sample = ++samples_since_sd >= rate_profile(activeProfile)->sd_decimation;
+        if (log_sample) {
+            samples_since_sd = 0;
+        }
+
+        // --- 2. Telemetry log at the profile's rate, behind whatever the pre-trigger recorder still holds
+        PROF_START(PROF_STAGE_TELEMETRY);
+#ifdef PRETRIGGER
+        telemetry_record_t queued;
+        if (log_sample) {
+            (void)pretrigger_push(&sample, &queued);    // Nothing is evicted once triggered
+        }
+        for (uint32_t n = 0; n < PRETRIGGER_FLUSH_BATCH && pretrigger_pop(&queued); n++) {
+            log_telemetry_sample(&queued);
+        }
+#else
+        if (log_sample) {
+            log_telemetry_sample(&sample);
+        }
+#endif
+        PROF_END(PROF_STAGE_TELEMETRY);
+
+        // --- 2b. Live downlink: packed and queued here, sent by DMA
+        PROF_START(PROF_STAGE_DOWNLINK);
+        downlink_telemetry(&sample);
+        PROF_END(PROF_STAGE_DOWNLINK);
+
+        // --- 3. Apogee detection (debounce style)
         if (current_altitude > ALTITUDE_MAX_GLOBAL) {
             ALTITUDE_MAX_GLOBAL = current_altitude;
         }
@@ -184,40 +445,59 @@ PhaseResult flight_phase() {
                 apogee_measures--;
                 if (apogee_measures <= 0) {
                     apogee_detected = true;
-                    char msg[64];
-                    snprintf(msg, sizeof(msg), "APOGEE detected at %.2f meters!", ALTITUDE_MAX_GLOBAL);
-                    log_event(hour, min, sec, ms, "EVENT", msg);
+                    event_log(EVT_APOGEE, ALTITUDE_MAX_GLOBAL);
                 }
             } else {
                 apogee_measures = APOGEE_DEBOUNCE;
             }
             last_altitude = current_altitude;
         } else {
-            // --- 7. Touchdown detection (after apogee)
+            // --- 4. Touchdown detection (after apogee), then POSTFLIGHT_LOG_MS on the ground at the post-flight rates
             if (!touchdown_detected && (current_altitude < (TOUCHDOWN_ALTITUDE_THRESHOLD + 0.5))) {
                 touchdown_detected = true;
-                char msg[64];
-                snprintf(msg, sizeof(msg), "TOUCHDOWN detected at %.2f m", current_altitude);
-                log_event(hour, min, sec, ms, "EVENT", msg);
+                touchdown_us = sample.timestamp_us;
+                event_log(EVT_TOUCHDOWN, current_altitude);
+                apply_rate_profile(RATE_PROFILE_POSTFLIGHT);
+            } else if (touchdown_detected &&
+                       sample.timestamp_us - touchdown_us >= (uint64_t)POSTFLIGHT_LOG_MS * 1000U) {
                 system_state = STATUS_POSTFLIGHT;
                 break;
             }
         }
 
+        // --- 5. Hand completed buffers to the SD card
+        PROF_START(PROF_STAGE_SD_SERVICE);
+        black_box_service();
+        PROF_END(PROF_STAGE_SD_SERVICE);
+        console_service();
+
+        PROF_END(PROF_STAGE_LOOP);
+
         //HAL_Delay(FLIGHT_LOG_DELAY_MS);
     }
 
+    MS5607_StopContinuous();
+    event_log(EVT_BARO_DROPPED, (unsigned)MS5607_DroppedSamples());
+    event_log(EVT_CONSOLE_DROPPED, (unsigned)console_dropped());
+    event_log(EVT_PRETRIGGER_OVERRUNS, (unsigned)pretrigger_overruns());
+    DownlinkStats downlink;
+    downlink_get_stats(&downlink);
+    event_log(EVT_DOWNLINK_STATS, (unsigned)downlink.frames_sent, (unsigned)downlink.frames_dropped,
+              (unsigned)downlink.decimation);
+
+    profiler_dump("FLIGHT");
+    scheduler_dump("FLIGHT");
     return PHASE_SUCCESS;
 }
 
 // --- PHASE: POST-FLIGHT ---
 PhaseResult post_flight_phase() {
-    log_event(0,0,0,0,"STATE","Entered POST-FLIGHT PHASE");
+    event_log(EVT_POSTFLIGHT_ENTERED);
     LED_SetState(STATUS_GRACEFUL_SHUTDOWN);
 
     // Flush files & unmount
     black_box_flush_all();
-    log_event(0,0,0,0,"INFO","SD files flushed and closed.");
+    event_log(EVT_SD_FLUSHED);
     unmount_sd_card();
     //log_event(0,0,0,0,"INFO","SD card unmounted.");
 
@@ -226,7 +506,7 @@ PhaseResult post_flight_phase() {
 
 // --- MAIN MANAGER LOGIC ---
 SystemState Manager_Main() {
-    log_event(0,0,0,0,"INFO","Sat Atmo - Diamant A Experience - Welcome!");
+    event_log(EVT_WELCOME);
 
     PhaseResult ret = init_phase();
     if(ret != PHASE_SUCCESS) return STATUS_ERROR;
@@ -243,13 +523,7 @@ SystemState Manager_Main() {
     return STATUS_GRACEFUL_SHUTDOWN;
 }
 
-// --- Timestamp function (stub) ---
+// --- Timestamp function (time since boot, from the TIM2 timebase) ---
 void get_timestamp(uint8_t *hour, uint8_t *min, uint8_t *sec, uint16_t *ms) {
-    // TODO: Replace with your actual RTC/timebase
-    static uint32_t counter = 0;
-    *hour = 0;
-    *min = 0;
-    *sec = (counter / 20) % 60;
-    *ms = (counter % 20) * 50;
-    counter++;
+    timebase_split(timebase_us(), hour, min, sec, ms);
 }
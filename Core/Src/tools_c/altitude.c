@@ -0,0 +1,55 @@
+/*
+ * altitude.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#include "tools_h/altitude.h"
+#include <stdint.h>
+#include <string.h>
+
+#define LOG2_E 1.44269504f
+#define LN_2   0.69314718f
+
+// log2(x) for x > 0: x = m * 2^e with m in [sqrt(1/2), sqrt(2)),
+// log2(m) = 2 * log2(e) * atanh(s), s = (m - 1) / (m + 1), |s| < 0.172
+static float fast_log2f(float x) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+
+    int32_t e = (int32_t)((bits >> 23) & 0xFF) - 127;
+    bits = (bits & 0x007FFFFFu) | 0x3F800000u;  // m in [1, 2)
+    float m;
+    memcpy(&m, &bits, sizeof(m));
+    if (m > 1.41421356f) {
+        m *= 0.5f;
+        e++;
+    }
+
+    float s = (m - 1.0f) / (m + 1.0f);
+    float s2 = s * s;
+    float atanh = s * (1.0f + s2 * (1.0f / 3.0f + s2 * (1.0f / 5.0f + s2 * (1.0f / 7.0f))));
+    return (float)e + 2.0f * LOG2_E * atanh;
+}
+
+// 2^x for |x| < 126: x = k + f with f in [-0.5, 0.5], 2^f from its Taylor series
+static float fast_exp2f(float x) {
+    int32_t k = (int32_t)(x + (x >= 0.0f ? 0.5f : -0.5f));
+    float t = (x - (float)k) * LN_2;
+    float p = 1.0f + t * (1.0f + t * (1.0f / 2.0f + t * (1.0f / 6.0f + t * (1.0f / 24.0f
+            + t * (1.0f / 120.0f + t * (1.0f / 720.0f))))));
+
+    uint32_t bits = (uint32_t)(k + 127) << 23;
+    float scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+float altitude_from_pressure(float pressure, float reference_pressure) {
+    if (pressure <= 0.0f || reference_pressure <= 0.0f) {
+        return 0.0f;
+    }
+    float ratio_pow = fast_exp2f(ALTITUDE_EXPONENT * fast_log2f(pressure / reference_pressure));
+    return ALTITUDE_SCALE_M * (1.0f - ratio_pow);
+}
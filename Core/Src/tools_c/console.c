@@ -0,0 +1,138 @@
+/*
+ * console.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#include "tools_h/console.h"
+#include "tools_h/configuration.h"
+#include "tools_h/ring.h"
+#include "tools_h/uart_stream.h"
+
+_Static_assert((CONSOLE_BUFFER_SIZE & (CONSOLE_BUFFER_SIZE - 1)) == 0, "CONSOLE_BUFFER_SIZE must be a power of two");
+_Static_assert((CONSOLE_EVENT_BUFFER_SIZE & (CONSOLE_EVENT_BUFFER_SIZE - 1)) == 0,
+               "CONSOLE_EVENT_BUFFER_SIZE must be a power of two");
+
+// Everything is statically initialised: printf works before any init code has run
+#if defined(CONSOLE_BACKEND_ITM)
+
+static uint8_t textStorage[CONSOLE_BUFFER_SIZE];
+static uint8_t eventStorage[CONSOLE_EVENT_BUFFER_SIZE];
+
+static Ring rings[CONSOLE_CHANNEL_COUNT] = {
+    [CONSOLE_CHANNEL_TEXT]   = { textStorage, 1, CONSOLE_BUFFER_SIZE - 1, 0, 0, 0 },
+    [CONSOLE_CHANNEL_EVENTS] = { eventStorage, 1, CONSOLE_EVENT_BUFFER_SIZE - 1, 0, 0, 0 },
+};
+
+static const uint8_t itmPorts[CONSOLE_CHANNEL_COUNT] = {
+    [CONSOLE_CHANNEL_TEXT]   = 0,
+    [CONSOLE_CHANNEL_EVENTS] = EVENT_LOG_ITM_PORT,
+};
+
+static bool ConsoleItmListening(uint32_t port) {
+    return (ITM->TCR & ITM_TCR_ITMENA_Msk) && (ITM->TER & (1UL << port));
+}
+
+bool console_write(ConsoleChannel channel, const void *data, uint32_t len) {
+    if (!ConsoleItmListening(itmPorts[channel])) {
+        return true;
+    }
+    return ring_write(&rings[channel], data, len);
+}
+
+void console_service(void) {
+    for (uint32_t channel = 0; channel < CONSOLE_CHANNEL_COUNT; channel++) {
+        Ring *ring = &rings[channel];
+        uint32_t port = itmPorts[channel];
+        uint32_t budget = CONSOLE_ITM_BURST;
+        const uint8_t *data;
+        uint32_t n;
+
+        if (!ConsoleItmListening(port)) {
+            // The debugger went away: what is queued has nowhere to go
+            ring_release(ring, ring_count(ring));
+            continue;
+        }
+        while (budget > 0 && (n = ring_peek(ring, &data)) != 0) {
+            uint32_t sent = 0;
+            if (n > budget) {
+                n = budget;
+            }
+            while (sent < n && ITM->PORT[port].u32 != 0UL) {
+                ITM->PORT[port].u8 = data[sent++];
+            }
+            ring_release(ring, sent);
+            budget -= sent;
+            if (sent < n) {
+                break;      // FIFO full: the rest goes on the next call
+            }
+        }
+    }
+}
+
+void console_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    (void)huart;
+}
+
+void console_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    (void)huart;
+}
+
+uint32_t console_dropped(void) {
+    return rings[CONSOLE_CHANNEL_TEXT].dropped + rings[CONSOLE_CHANNEL_EVENTS].dropped;
+}
+
+#elif defined(CONSOLE_BACKEND_UART)
+
+static uint8_t textStorage[CONSOLE_BUFFER_SIZE];
+static UartStream consoleUart = UART_STREAM_INIT(textStorage, CONSOLE_BUFFER_SIZE, &huart2);
+
+bool console_write(ConsoleChannel channel, const void *data, uint32_t len) {
+    if (channel != CONSOLE_CHANNEL_TEXT) {
+        return true;
+    }
+    return uart_stream_write(&consoleUart, data, len);
+}
+
+void console_service(void) {
+    uart_stream_kick(&consoleUart);
+}
+
+void console_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    uart_stream_TxCpltCallback(&consoleUart, huart);
+}
+
+void console_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    uart_stream_ErrorCallback(&consoleUart, huart);
+}
+
+uint32_t console_dropped(void) {
+    return consoleUart.ring.dropped;
+}
+
+#else /* No backend: the console is compiled in but silent */
+
+bool console_write(ConsoleChannel channel, const void *data, uint32_t len) {
+    (void)channel;
+    (void)data;
+    (void)len;
+    return true;
+}
+
+void console_service(void) {
+}
+
+void console_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    (void)huart;
+}
+
+void console_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    (void)huart;
+}
+
+uint32_t console_dropped(void) {
+    return 0;
+}
+
+#endif
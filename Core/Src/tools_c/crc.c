@@ -0,0 +1,42 @@
+/*
+ * crc.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#include "tools_h/crc.h"
+
+// Nibble table: 32 bytes of flash, two lookups per byte
+static const uint16_t crc16_nibble_table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+static const uint8_t crc8_nibble_table[16] = {
+    0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15,
+    0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D
+};
+
+uint16_t crc16_ccitt(const void *data, size_t len, uint16_t crc) {
+    const uint8_t *p = (const uint8_t *)data;
+
+    while (len--) {
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble_table[((crc >> 12) ^ (*p >> 4)) & 0x0F]);
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble_table[((crc >> 12) ^ (*p & 0x0F)) & 0x0F]);
+        p++;
+    }
+    return crc;
+}
+
+uint8_t crc8(const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    uint8_t crc = 0x00;
+
+    while (len--) {
+        crc = (uint8_t)((crc << 4) ^ crc8_nibble_table[((crc >> 4) ^ (*p >> 4)) & 0x0F]);
+        crc = (uint8_t)((crc << 4) ^ crc8_nibble_table[((crc >> 4) ^ (*p & 0x0F)) & 0x0F]);
+        p++;
+    }
+    return crc;
+}
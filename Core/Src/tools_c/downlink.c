@@ -0,0 +1,195 @@
+/*
+ * downlink.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#include "tools_h/downlink.h"
+#include "tools_h/configuration.h"
+#include "tools_h/crc.h"
+#include "tools_h/uart_stream.h"
+#include <stddef.h>
+#include <string.h>
+
+#ifdef DOWNLINK
+
+_Static_assert((DOWNLINK_QUEUE_SIZE & (DOWNLINK_QUEUE_SIZE - 1)) == 0, "DOWNLINK_QUEUE_SIZE must be a power of two");
+_Static_assert(DOWNLINK_MAX_DECIMATION <= 255, "the frame carries the decimation in a byte");
+
+// Link budget in bytes per second (10 bits per byte on an 8N1 line)
+#define DOWNLINK_BUDGET_BYTES_S  ((uint64_t)DOWNLINK_LINK_BPS / 10U * DOWNLINK_BUDGET_PERCENT / 100U)
+
+static uint8_t queueStorage[DOWNLINK_QUEUE_SIZE];
+static UartStream link;
+
+static uint16_t seq;
+static uint32_t framesSent;
+static uint32_t framesDropped;
+static uint32_t samplesPending;     // Samples offered since the last frame
+static uint32_t decimation = 1;
+static uint32_t minDecimation = 1;  // Floor set by the phase rate profile
+static uint64_t lastSampleUs;
+static uint32_t intervalUs;         // Smoothed interval between samples, 0 until known
+
+// Rounded and clamped to [lo, hi]; NaN gives lo
+static int32_t DownlinkFixed(float value, float scale, int32_t lo, int32_t hi) {
+    float v = value * scale;
+    if (!(v >= (float)lo)) return lo;
+    if (v >= (float)hi) return hi;
+    return (int32_t)(v + (v >= 0.0f ? 0.5f : -0.5f));
+}
+
+/*
+ * Consistent Overhead Byte Stuffing: no 0x00 in the output, one code byte
+ * of overhead per 254 bytes. out must hold len + len / 254 + 1 bytes.
+ */
+static uint32_t DownlinkCobsEncode(const uint8_t *in, uint32_t len, uint8_t *out) {
+    uint32_t code_at = 0, out_len = 1;
+    uint8_t code = 1;
+
+    for (uint32_t i = 0; i < len; i++) {
+        if (in[i] == 0) {
+            out[code_at] = code;
+            code_at = out_len++;
+            code = 1;
+            continue;
+        }
+        out[out_len++] = in[i];
+        if (++code == 0xFF) {
+            out[code_at] = code;
+            code_at = out_len++;
+            code = 1;
+        }
+    }
+    out[code_at] = code;
+    return out_len;
+}
+
+// Samples per frame that keep the frame rate within the link budget
+static void DownlinkUpdateDecimation(uint64_t timestamp_us) {
+    if (lastSampleUs != 0 && timestamp_us > lastSampleUs) {
+        uint64_t dt = timestamp_us - lastSampleUs;
+        if (dt > 1000000U) {
+            dt = 1000000U;              // A stall is not the sample rate
+        }
+        intervalUs = intervalUs == 0 ? (uint32_t)dt : intervalUs + ((int32_t)((uint32_t)dt - intervalUs) >> 3);
+    }
+    lastSampleUs = timestamp_us;
+    if (intervalUs == 0) {
+        return;
+    }
+
+    // frames/s at full rate * bytes per frame / budget, rounded up
+    uint64_t need = (uint64_t)DOWNLINK_WIRE_MAX * 1000000U;
+    uint64_t have = (uint64_t)intervalUs * DOWNLINK_BUDGET_BYTES_S;
+    uint32_t n = (uint32_t)((need + have - 1) / have);
+    n = n < 1 ? 1 : n > DOWNLINK_MAX_DECIMATION ? DOWNLINK_MAX_DECIMATION : n;
+    decimation = n < minDecimation ? minDecimation : n;
+}
+
+void downlink_init(UART_HandleTypeDef *huart) {
+    uart_stream_init(&link, huart, queueStorage, sizeof(queueStorage));
+    seq = 0;
+    framesSent = 0;
+    framesDropped = 0;
+    samplesPending = 0;
+    decimation = 1;
+    minDecimation = 1;
+    lastSampleUs = 0;
+    intervalUs = 0;
+}
+
+void downlink_set_min_decimation(uint32_t n) {
+    minDecimation = n < 1 ? 1 : n > UINT8_MAX ? UINT8_MAX : n;
+    if (decimation < minDecimation) {
+        decimation = minDecimation;
+    }
+}
+
+bool downlink_telemetry(const telemetry_record_t *sample) {
+    downlink_telemetry_frame_t frame;
+    uint8_t wire[DOWNLINK_WIRE_MAX];
+
+    if (link.huart == NULL) {
+        return false;
+    }
+    DownlinkUpdateDecimation(sample->timestamp_us);
+    if (++samplesPending < decimation) {
+        return false;
+    }
+
+    frame.type = DOWNLINK_FRAME_TELEMETRY;
+    frame.decimation = (uint8_t)samplesPending;
+    frame.seq = seq++;
+    frame.time_ms = (uint32_t)(sample->timestamp_us / 1000U);
+    frame.pressure_dpa = (uint32_t)DownlinkFixed(sample->ms5607_pressure, 10.0f, 0, INT32_MAX);
+    frame.temperature_cdeg = (int16_t)DownlinkFixed(sample->ms5607_temperature, 100.0f, INT16_MIN, INT16_MAX);
+    frame.altitude_cm = DownlinkFixed(sample->ms5607_altitude, 100.0f, INT32_MIN, INT32_MAX);
+    frame.pm2_5_dug = (uint16_t)DownlinkFixed(sample->sds011_pm2_5, 10.0f, 0, UINT16_MAX);
+    frame.pm10_dug = (uint16_t)DownlinkFixed(sample->sds011_pm10, 10.0f, 0, UINT16_MAX);
+    frame.aqi = (uint8_t)DownlinkFixed(sample->ens160_AQI, 1.0f, 0, UINT8_MAX);
+    frame.tvoc_ppb = (uint16_t)DownlinkFixed(sample->ens160_TVOC, 1.0f, 0, UINT16_MAX);
+    frame.eco2_ppm = (uint16_t)DownlinkFixed(sample->ens160_eCO2, 1.0f, 0, UINT16_MAX);
+    frame.aht21_temperature_cdeg = (int16_t)DownlinkFixed(sample->aht21_temperature, 100.0f, INT16_MIN, INT16_MAX);
+    frame.aht21_humidity_cpct = (uint16_t)DownlinkFixed(sample->aht21_humidity, 100.0f, 0, UINT16_MAX);
+    frame.mics5524_mv = (uint16_t)DownlinkFixed(sample->mics5524_voltage, 1000.0f, 0, UINT16_MAX);
+    frame.crc = crc16_ccitt(&frame, offsetof(downlink_telemetry_frame_t, crc), CRC16_CCITT_INIT);
+    samplesPending = 0;
+
+    uint32_t len = DownlinkCobsEncode((const uint8_t *)&frame, sizeof(frame), wire);
+    wire[len++] = 0x00;
+    if (!uart_stream_write(&link, wire, len)) {
+        framesDropped++;
+        return false;
+    }
+    framesSent++;
+    return true;
+}
+
+void downlink_get_stats(DownlinkStats *stats) {
+    stats->frames_sent = framesSent;
+    stats->frames_dropped = framesDropped;
+    stats->decimation = decimation;
+}
+
+void downlink_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    if (link.huart != NULL) {
+        uart_stream_TxCpltCallback(&link, huart);
+    }
+}
+
+void downlink_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    if (link.huart != NULL) {
+        uart_stream_ErrorCallback(&link, huart);
+    }
+}
+
+#else /* !DOWNLINK */
+
+void downlink_init(UART_HandleTypeDef *huart) {
+    (void)huart;
+}
+
+bool downlink_telemetry(const telemetry_record_t *sample) {
+    (void)sample;
+    return false;
+}
+
+void downlink_set_min_decimation(uint32_t n) {
+    (void)n;
+}
+
+void downlink_get_stats(DownlinkStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+}
+
+void downlink_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    (void)huart;
+}
+
+void downlink_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    (void)huart;
+}
+
+#endif /* DOWNLINK */
@@ -0,0 +1,145 @@
+/*
+ * event_log.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#include "tools_h/event_log.h"
+#include "tools_h/configuration.h"
+#include "tools_h/timebase.h"
+#include "tools_h/console.h"
+#include "tools_h/crc.h"
+#include "drivers_h/black_box.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LOG_TOKEN_FIELD_ARGS(id, name, level, args, format) [id] = args,
+static const char *const tokenArgs[LOG_TOKEN_LIMIT] = {
+    LOG_TOKEN_TABLE(LOG_TOKEN_FIELD_ARGS)
+};
+#undef LOG_TOKEN_FIELD_ARGS
+
+#ifdef EVENT_LOG_TOKENIZED
+
+static uint32_t timeHigh;
+
+// Raw records on their own stimulus port, so printf text on port 0 is unaffected.
+// Whole records are queued or dropped, so the stream never loses sync.
+static void EventLogSwv(const uint8_t *data, uint32_t len) {
+#ifdef SWV_DEBUG
+    console_write(CONSOLE_CHANNEL_EVENTS, data, len);
+#else
+    (void)data;
+    (void)len;
+#endif
+}
+
+void event_log(log_token_t token, ...) {
+    uint8_t record[EVENT_LOG_RECORD_MAX];
+    uint32_t len = EVENT_LOG_RECORD_HEADER;
+    uint64_t now_us = timebase_us();
+    const char *args;
+    va_list ap;
+
+    if ((uint32_t)token >= LOG_TOKEN_LIMIT || (args = tokenArgs[token]) == NULL) {
+        return;
+    }
+    if ((uint32_t)(now_us >> 32) != timeHigh) {
+        timeHigh = (uint32_t)(now_us >> 32);
+        event_log(EVT_TIME_HIGH, (unsigned)timeHigh);
+    }
+
+    record[1] = (uint8_t)token;
+    record[2] = (uint8_t)(token >> 8);
+    uint32_t low = (uint32_t)now_us;
+    memcpy(&record[3], &low, sizeof(low));
+
+    va_start(ap, token);
+    for (; *args; args++) {
+        switch (*args) {
+        case 'f': {
+            float v = (float)va_arg(ap, double);
+            memcpy(&record[len], &v, sizeof(v));
+            len += sizeof(v);
+            break;
+        }
+        case 'i': {
+            int32_t v = va_arg(ap, int);
+            memcpy(&record[len], &v, sizeof(v));
+            len += sizeof(v);
+            break;
+        }
+        case 'u': {
+            uint32_t v = va_arg(ap, unsigned);
+            memcpy(&record[len], &v, sizeof(v));
+            len += sizeof(v);
+            break;
+        }
+        case 's': {
+            const char *s = va_arg(ap, const char *);
+            size_t n = strnlen(s, EVENT_LOG_STRING_MAX);
+            // Room is left for the remaining arguments of the largest signature (4 bytes each) and the CRC
+            size_t room = sizeof(record) - len - 2 - 4 * strlen(args + 1);
+            if (n > room) {
+                n = room;
+            }
+            record[len++] = (uint8_t)n;
+            memcpy(&record[len], s, n);
+            len += n;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    va_end(ap);
+
+    record[0] = (uint8_t)(len - EVENT_LOG_RECORD_HEADER);
+    record[len] = crc8(record, len);
+    len++;
+    black_box_write_event(record, (uint16_t)len);
+    EventLogSwv(record, len);
+}
+
+#else /* !EVENT_LOG_TOKENIZED */
+
+#define LOG_TOKEN_FIELD_LEVEL(id, name, level, args, format) [id] = level,
+static const char *const tokenLevels[LOG_TOKEN_LIMIT] = {
+    LOG_TOKEN_TABLE(LOG_TOKEN_FIELD_LEVEL)
+};
+#undef LOG_TOKEN_FIELD_LEVEL
+
+#define LOG_TOKEN_FIELD_FORMAT(id, name, level, args, format) [id] = format,
+static const char *const tokenFormats[LOG_TOKEN_LIMIT] = {
+    LOG_TOKEN_TABLE(LOG_TOKEN_FIELD_FORMAT)
+};
+#undef LOG_TOKEN_FIELD_FORMAT
+
+void event_log(log_token_t token, ...) {
+    char message[LOG_BUFFER_SIZE];
+    uint8_t hour, min, sec;
+    uint16_t ms;
+    va_list ap;
+
+    if ((uint32_t)token >= LOG_TOKEN_LIMIT || tokenArgs[token] == NULL) {
+        return;
+    }
+
+    va_start(ap, token);
+    if (token == EVT_TEXT) {
+        const char *level = va_arg(ap, const char *);
+        const char *text = va_arg(ap, const char *);
+        va_end(ap);
+        log_event(0, 0, 0, 0, level, text);
+        return;
+    }
+    vsnprintf(message, sizeof(message), tokenFormats[token], ap);
+    va_end(ap);
+
+    timebase_split(timebase_us(), &hour, &min, &sec, &ms);
+    log_event(hour, min, sec, ms, tokenLevels[token], message);
+}
+
+#endif /* EVENT_LOG_TOKENIZED */
@@ -0,0 +1,127 @@
+/*
+ * lz_stream.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#include "tools_h/lz_stream.h"
+#include "tools_h/configuration.h"
+#include <string.h>
+
+#define LZ_MASK (LZ_WINDOW_SIZE - 1u)
+
+static uint32_t LzHash(const lz_stream_t *lz, uint32_t pos) {
+    uint32_t v = ((uint32_t)lz->window[pos & LZ_MASK] << 16)
+               | ((uint32_t)lz->window[(pos + 1) & LZ_MASK] << 8)
+               | lz->window[(pos + 2) & LZ_MASK];
+    return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+// Chains every position before limit whose three bytes are all in the window
+static void LzInsert(lz_stream_t *lz, uint32_t limit) {
+    while (lz->hashed < limit && lz->hashed + 2 < lz->total) {
+        uint32_t h = LzHash(lz, lz->hashed);
+        lz->prev[lz->hashed & LZ_MASK] = lz->head[h];
+        lz->head[h] = (uint16_t)lz->hashed;
+        lz->hashed++;
+    }
+}
+
+static void LzEmitGroup(lz_stream_t *lz) {
+    lz->sink(lz->ctx, lz->group, lz->group_len);
+    lz->bytes_out += lz->group_len;
+    lz->group[0] = 0;
+    lz->group_len = 1;
+    lz->group_items = 0;
+}
+
+static void LzEmit(lz_stream_t *lz, uint32_t offset, uint32_t length) {
+    if (length == 0) {
+        lz->group[lz->group_len++] = lz->window[lz->cursor & LZ_MASK];
+    } else {
+        lz->group[0] |= (uint8_t)(1u << lz->group_items);
+        lz->group[lz->group_len++] = (uint8_t)offset;
+        lz->group[lz->group_len++] = (uint8_t)((offset >> 8) | ((length - LZ_MIN_MATCH) << 3));
+    }
+    if (++lz->group_items == 8) {
+        LzEmitGroup(lz);
+    }
+}
+
+// Encodes one literal or match at the cursor
+static void LzStep(lz_stream_t *lz) {
+    uint32_t lookahead = lz->total - lz->cursor;
+    uint32_t best_len = 0, best_offset = 0;
+
+    LzInsert(lz, lz->cursor);
+    if (lookahead >= LZ_MIN_MATCH) {
+        uint32_t limit = (lookahead < LZ_MAX_MATCH) ? lookahead : LZ_MAX_MATCH;
+        uint16_t candidate = lz->head[LzHash(lz, lz->cursor)];
+        uint32_t last = 0;
+
+        for (uint32_t chain = 0; chain < LZ_MAX_CHAIN; chain++) {
+            // 16-bit positions: distances only grow along a valid chain, anything else is stale
+            uint32_t offset = (uint16_t)((uint16_t)lz->cursor - candidate);
+            if (offset <= last || offset > LZ_MAX_OFFSET || offset > lz->cursor) {
+                break;
+            }
+            uint32_t len = 0;
+            while (len < limit &&
+                   lz->window[(lz->cursor - offset + len) & LZ_MASK] == lz->window[(lz->cursor + len) & LZ_MASK]) {
+                len++;
+            }
+            if (len > best_len) {
+                best_len = len;
+                best_offset = offset;
+                if (len == limit) {
+                    break;
+                }
+            }
+            last = offset;
+            candidate = lz->prev[candidate & LZ_MASK];
+        }
+    }
+
+    if (best_len >= LZ_MIN_MATCH) {
+        LzEmit(lz, best_offset, best_len);
+        lz->cursor += best_len;
+    } else {
+        LzEmit(lz, 0, 0);
+        lz->cursor++;
+    }
+}
+
+void lz_stream_init(lz_stream_t *lz, lz_sink_t sink, void *ctx) {
+    // Lives in SRAM2_NOINIT memory, which the startup code does not clear
+    memset(lz, 0, sizeof(*lz));
+    lz->sink = sink;
+    lz->ctx = ctx;
+    lz->group_len = 1;
+}
+
+void lz_stream_write(lz_stream_t *lz, const void *data, uint32_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+
+    lz->bytes_in += len;
+    while (len--) {
+        lz->window[lz->total & LZ_MASK] = *p++;
+        lz->total++;
+        if (lz->total - lz->cursor >= LZ_MAX_MATCH) {
+            LzStep(lz);
+        }
+    }
+}
+
+void lz_stream_flush(lz_stream_t *lz) {
+    while (lz->cursor < lz->total) {
+        LzStep(lz);
+    }
+    if (lz->group_items > 0) {
+        // Sync marker: a match with offset 0 closes the partial group
+        lz->group[0] |= (uint8_t)(1u << lz->group_items);
+        lz->group[lz->group_len++] = 0;
+        lz->group[lz->group_len++] = 0;
+        LzEmitGroup(lz);
+    }
+}
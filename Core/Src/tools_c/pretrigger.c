@@ -0,0 +1,100 @@
+/*
+ * pretrigger.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#include "tools_h/pretrigger.h"
+#include "tools_h/configuration.h"
+
+#ifdef PRETRIGGER
+
+static SRAM2_NOINIT telemetry_record_t records[PRETRIGGER_RECORDS];
+static uint32_t head;       // Samples pushed
+static uint32_t tail;       // Samples popped or dropped; head - tail are buffered
+static bool triggered;
+static uint32_t overruns;
+
+void pretrigger_init(void) {
+    head = 0;
+    tail = 0;
+    triggered = false;
+    overruns = 0;
+}
+
+bool pretrigger_push(const telemetry_record_t *sample, telemetry_record_t *evicted) {
+    bool out = false;
+
+    if (head - tail == PRETRIGGER_RECORDS) {
+        if (triggered) {
+            overruns++;
+        } else {
+            *evicted = records[tail % PRETRIGGER_RECORDS];
+            out = true;
+        }
+        tail++;
+    }
+    records[head % PRETRIGGER_RECORDS] = *sample;
+    head++;
+    return out;
+}
+
+uint32_t pretrigger_trigger(uint64_t now_us) {
+    uint64_t window_us = (uint64_t)PRETRIGGER_SECONDS * 1000000U;
+    uint64_t cutoff_us = (now_us > window_us) ? now_us - window_us : 0;
+
+    while (tail != head && records[tail % PRETRIGGER_RECORDS].timestamp_us < cutoff_us) {
+        tail++;
+    }
+    triggered = true;
+    return head - tail;
+}
+
+uint64_t pretrigger_oldest_us(void) {
+    return (tail == head) ? 0 : records[tail % PRETRIGGER_RECORDS].timestamp_us;
+}
+
+bool pretrigger_pop(telemetry_record_t *sample) {
+    if (tail == head) {
+        return false;
+    }
+    *sample = records[tail % PRETRIGGER_RECORDS];
+    tail++;
+    return true;
+}
+
+uint32_t pretrigger_overruns(void) {
+    return overruns;
+}
+
+#else /* !PRETRIGGER */
+
+void pretrigger_init(void) {
+}
+
+// Nothing is held back: every sample goes straight through
+bool pretrigger_push(const telemetry_record_t *sample, telemetry_record_t *evicted) {
+    *evicted = *sample;
+    return true;
+}
+
+uint32_t pretrigger_trigger(uint64_t now_us) {
+    (void)now_us;
+    return 0;
+}
+
+uint64_t pretrigger_oldest_us(void) {
+    return 0;
+}
+
+bool pretrigger_pop(telemetry_record_t *sample) {
+    (void)sample;
+    return false;
+}
+
+uint32_t pretrigger_overruns(void) {
+    return 0;
+}
+
+#endif /* PRETRIGGER */
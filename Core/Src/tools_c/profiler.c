@@ -0,0 +1,86 @@
+/*
+ * profiler.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#include "tools_h/profiler.h"
+
+#ifdef PROFILER
+
+#include <stdio.h>
+#include "tools_h/logger.h"
+#include "drivers_h/black_box.h"
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t hist[PROFILER_HIST_BUCKETS];
+} ProfilerStats;
+
+static const char *const stage_names[PROF_STAGE_COUNT] = {
+    "loop", "barometer", "sds011", "ens160", "aht21", "mics5524", "telemetry", "downlink", "sd_service"
+};
+
+static ProfilerStats stats[PROF_STAGE_COUNT];
+
+void profiler_reset(void) {
+    for (int i = 0; i < PROF_STAGE_COUNT; i++) {
+        stats[i] = (ProfilerStats){ .min = UINT32_MAX };
+    }
+}
+
+void profiler_init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    profiler_reset();
+}
+
+void profiler_record(ProfilerStage stage, uint32_t cycles) {
+    ProfilerStats *s = &stats[stage];
+    uint32_t bucket = cycles ? 32u - (uint32_t)__builtin_clz(cycles) : 0;
+
+    if (bucket >= PROFILER_HIST_BUCKETS) bucket = PROFILER_HIST_BUCKETS - 1;
+    s->hist[bucket]++;
+    s->count++;
+    s->sum += cycles;
+    if (cycles < s->min) s->min = cycles;
+    if (cycles > s->max) s->max = cycles;
+}
+
+void profiler_dump(const char *phase) {
+    const uint32_t cycles_per_us = SystemCoreClock / 1000000u;
+    char line[224];
+    int len;
+
+    len = snprintf(line, sizeof(line), "%s: %lu MHz, times in us, histogram k:n = n samples below 2^k cycles",
+                   phase, (unsigned long)cycles_per_us);
+    log_print("[PROFILE] %s\n", line);
+    log_event(0, 0, 0, 0, "PROFILE", line);
+
+    for (int i = 0; i < PROF_STAGE_COUNT; i++) {
+        const ProfilerStats *s = &stats[i];
+        if (s->count == 0) continue;
+
+        len = snprintf(line, sizeof(line), "%s n=%lu min=%lu mean=%lu max=%lu |",
+                       stage_names[i], (unsigned long)s->count,
+                       (unsigned long)(s->min / cycles_per_us),
+                       (unsigned long)(s->sum / s->count / cycles_per_us),
+                       (unsigned long)(s->max / cycles_per_us));
+        for (int k = 0; k < PROFILER_HIST_BUCKETS && len > 0 && len < (int)sizeof(line); k++) {
+            if (s->hist[k]) {
+                len += snprintf(line + len, sizeof(line) - len, " %d:%lu", k, (unsigned long)s->hist[k]);
+            }
+        }
+        log_print("[PROFILE] %s\n", line);
+        log_event(0, 0, 0, 0, "PROFILE", line);
+    }
+
+    profiler_reset();
+}
+
+#endif /* PROFILER */
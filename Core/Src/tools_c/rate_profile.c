@@ -0,0 +1,75 @@
+/*
+ * rate_profile.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#include "tools_h/rate_profile.h"
+
+#define RATE_PROFILE_ENTRY(name, sds011, ens160, aht21, mics5524, sd, downlink) \
+    [RATE_PROFILE_##name] = { #name, sds011, ens160, aht21, mics5524, sd, downlink },
+static const RateProfile profiles[RATE_PROFILE_COUNT] = {
+    RATE_PROFILE_TABLE(RATE_PROFILE_ENTRY)
+};
+#undef RATE_PROFILE_ENTRY
+
+#define RATE_LEAVE_APOGEE_MPS (1.5f * RATE_APOGEE_SPEED_MPS)
+
+const RateProfile *rate_profile(RateProfileId id) {
+    return &profiles[(id < RATE_PROFILE_COUNT) ? id : RATE_PROFILE_PREFLIGHT];
+}
+
+RateProfileId rate_profile_select(RateProfileId current, float vertical_speed, bool apogee_detected,
+                                  uint32_t in_profile_ms) {
+    switch (current) {
+    // Always through APOGEE, on the speed or on the altitude-based detection, whichever comes first
+    case RATE_PROFILE_ASCENT:
+        return (apogee_detected || vertical_speed < RATE_APOGEE_SPEED_MPS) ? RATE_PROFILE_APOGEE : current;
+    // Held for RATE_APOGEE_MIN_MS and until apogee detection agrees: on a sharp turnaround both fire
+    // just after the apex, and the dwell keeps the burst over the top of the trajectory
+    case RATE_PROFILE_APOGEE:
+        if (in_profile_ms < RATE_APOGEE_MIN_MS) return current;
+        if (apogee_detected && vertical_speed < -RATE_LEAVE_APOGEE_MPS) return RATE_PROFILE_DESCENT;
+        if (!apogee_detected && vertical_speed > RATE_LEAVE_APOGEE_MPS) return RATE_PROFILE_ASCENT;
+        return current;
+    case RATE_PROFILE_DESCENT:
+        return current;
+    default:
+        return apogee_detected ? RATE_PROFILE_DESCENT : RATE_PROFILE_ASCENT;
+    }
+}
+
+#define RATE_SPEED_SLOT_US ((uint64_t)RATE_SPEED_WINDOW_MS * 1000U / RATE_SPEED_SLOTS)
+
+void vertical_speed_reset(VerticalSpeed *vs) {
+    vs->newest = 0;
+    vs->count = 0;
+    vs->speed = 0.0f;
+}
+
+float vertical_speed_update(VerticalSpeed *vs, float altitude, uint64_t timestamp_us) {
+    if (vs->count == 0) {
+        vs->altitude = altitude;
+    } else {
+        vs->altitude += (altitude - vs->altitude) * 0.25f;
+    }
+
+    // A new checkpoint every window/slots; once full, the oldest one is overwritten
+    if (vs->count == 0 || timestamp_us - vs->slot_us[vs->newest] >= RATE_SPEED_SLOT_US) {
+        vs->newest = (uint8_t)((vs->newest + 1) % RATE_SPEED_SLOTS);
+        vs->slot_altitude[vs->newest] = vs->altitude;
+        vs->slot_us[vs->newest] = timestamp_us;
+        if (vs->count < RATE_SPEED_SLOTS) {
+            vs->count++;
+        }
+    }
+
+    // Against the oldest checkpoint: between (slots - 1)/slots and one full window back
+    uint8_t oldest = (uint8_t)((vs->newest + RATE_SPEED_SLOTS + 1 - vs->count) % RATE_SPEED_SLOTS);
+    uint64_t dt_us = timestamp_us - vs->slot_us[oldest];
+    if (dt_us > 0) {
+        vs->speed = (vs->altitude - vs->slot_altitude[oldest]) * 1e6f / (float)dt_us;
+    }
+    return vs->speed;
+}
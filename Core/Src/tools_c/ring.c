@@ -0,0 +1,98 @@
+/*
+ * ring.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#include "tools_h/ring.h"
+#include "stm32l4xx_hal.h"
+#include <string.h>
+
+bool ring_init(Ring *ring, void *storage, uint32_t item_size, uint32_t capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return false;
+    }
+    ring->storage = (uint8_t *)storage;
+    ring->item_size = item_size;
+    ring->mask = capacity - 1;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->dropped = 0;
+    return true;
+}
+
+bool ring_push(Ring *ring, const void *item) {
+    uint32_t head = ring->head;
+
+    if (head - ring->tail > ring->mask) {
+        ring->dropped++;
+        return false;
+    }
+    // The tail read above must not be satisfied after the slot is overwritten
+    __DMB();
+    memcpy(&ring->storage[(head & ring->mask) * ring->item_size], item, ring->item_size);
+    // Publish the item before the index that makes it visible
+    __DMB();
+    ring->head = head + 1;
+    return true;
+}
+
+bool ring_pop(Ring *ring, void *item) {
+    uint32_t tail = ring->tail;
+
+    if (ring->head == tail) {
+        return false;
+    }
+    // Do not read the slot before the head that covers it
+    __DMB();
+    memcpy(item, &ring->storage[(tail & ring->mask) * ring->item_size], ring->item_size);
+    // Finish the copy before the slot is handed back to the producer
+    __DMB();
+    ring->tail = tail + 1;
+    return true;
+}
+
+uint32_t ring_count(const Ring *ring) {
+    return ring->head - ring->tail;
+}
+
+bool ring_write(Ring *ring, const void *data, uint32_t len) {
+    uint32_t head = ring->head;
+    uint32_t capacity = ring->mask + 1;
+
+    if (len > capacity - (head - ring->tail)) {
+        ring->dropped += len;
+        return false;
+    }
+    __DMB();
+    uint32_t start = head & ring->mask;
+    uint32_t first = capacity - start;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(&ring->storage[start], data, first);
+    memcpy(ring->storage, (const uint8_t *)data + first, len - first);
+    __DMB();
+    ring->head = head + len;
+    return true;
+}
+
+uint32_t ring_peek(const Ring *ring, const uint8_t **data) {
+    uint32_t tail = ring->tail;
+    uint32_t count = ring->head - tail;
+    uint32_t start = tail & ring->mask;
+
+    if (count > ring->mask + 1 - start) {
+        count = ring->mask + 1 - start;
+    }
+    // The caller reads the bytes after this: keep it behind the head read
+    __DMB();
+    *data = &ring->storage[start];
+    return count;
+}
+
+void ring_release(Ring *ring, uint32_t len) {
+    __DMB();
+    ring->tail += len;
+}
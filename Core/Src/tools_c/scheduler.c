@@ -0,0 +1,106 @@
+/*
+ * scheduler.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#include "tools_h/scheduler.h"
+#include <stdio.h>
+#include "tools_h/configuration.h"
+#include "tools_h/timebase.h"
+#include "tools_h/logger.h"
+#include "drivers_h/black_box.h"
+
+typedef struct {
+    const char *name;
+    SchedulerTaskFn run;
+    uint32_t period_us;
+    uint32_t deadline_us;
+    uint64_t release_us;
+    uint32_t runs;
+    uint32_t misses;
+    uint32_t max_lateness_us;
+} SchedulerTask;
+
+static SchedulerTask tasks[SCHEDULER_MAX_TASKS];
+static uint8_t taskCount;
+
+int scheduler_add(const char *name, SchedulerTaskFn run, uint32_t period_us,
+                  uint32_t deadline_us, uint32_t offset_us) {
+    if (taskCount >= SCHEDULER_MAX_TASKS || run == NULL) {
+        return -1;
+    }
+
+    uint64_t now = timebase_us();
+    tasks[taskCount] = (SchedulerTask){
+        .name = name,
+        .run = run,
+        .period_us = period_us,
+        .deadline_us = deadline_us,
+        .release_us = now + offset_us,
+    };
+    return taskCount++;
+}
+
+void scheduler_set_period(int id, uint32_t period_us) {
+    if (id < 0 || id >= taskCount) {
+        return;
+    }
+
+    SchedulerTask *task = &tasks[id];
+    uint64_t next = timebase_us() + period_us;
+    if (task->period_us != 0 && task->release_us > next) {
+        task->release_us = next;
+    }
+    task->period_us = period_us;
+}
+
+uint8_t scheduler_run_due(void) {
+    uint8_t ran = 0;
+
+    for (uint8_t i = 0; i < taskCount; i++) {
+        SchedulerTask *task = &tasks[i];
+        uint64_t now = timebase_us();
+
+        if (now < task->release_us) {
+            continue;
+        }
+
+        if (task->period_us != 0) {
+            uint64_t lateness = now - task->release_us;
+            if (lateness > task->max_lateness_us) {
+                task->max_lateness_us = (lateness > UINT32_MAX) ? UINT32_MAX : (uint32_t)lateness;
+            }
+            if (task->deadline_us != 0 && lateness > task->deadline_us) {
+                task->misses++;
+                task->release_us = now + task->period_us;   // Realign instead of running a burst to catch up
+            } else {
+                task->release_us += task->period_us;
+            }
+        }
+
+        task->run(now);
+        task->runs++;
+        ran++;
+    }
+    return ran;
+}
+
+void scheduler_reset(void) {
+    taskCount = 0;
+}
+
+void scheduler_dump(const char *phase) {
+    char line[96];
+
+    for (uint8_t i = 0; i < taskCount; i++) {
+        const SchedulerTask *task = &tasks[i];
+        snprintf(line, sizeof(line), "%s %-10s period %lu us: %lu runs, %lu misses, late max %lu us",
+                 phase, task->name,
+                 (unsigned long)task->period_us, (unsigned long)task->runs,
+                 (unsigned long)task->misses, (unsigned long)task->max_lateness_us);
+        log_print("[SCHED] %s\n", line);
+        log_event(0, 0, 0, 0, "SCHED", line);
+    }
+}
@@ -0,0 +1,106 @@
+/*
+ * telemetry_codec.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#include "tools_h/telemetry_codec.h"
+#include "tools_h/configuration.h"
+#include "tools_h/crc.h"
+#include <stddef.h>
+#include <string.h>
+
+// Offsets rather than a float array: the record is packed, and VLDR faults on unaligned addresses
+static const uint8_t fieldOffsets[TELEMETRY_FIELD_COUNT] = {
+    offsetof(telemetry_record_t, ms5607_temperature),
+    offsetof(telemetry_record_t, ms5607_pressure),
+    offsetof(telemetry_record_t, ms5607_altitude),
+    offsetof(telemetry_record_t, sds011_pm2_5),
+    offsetof(telemetry_record_t, sds011_pm10),
+    offsetof(telemetry_record_t, ens160_AQI),
+    offsetof(telemetry_record_t, ens160_TVOC),
+    offsetof(telemetry_record_t, ens160_eCO2),
+    offsetof(telemetry_record_t, aht21_temperature),
+    offsetof(telemetry_record_t, aht21_humidity),
+    offsetof(telemetry_record_t, mics5524_voltage),
+};
+
+static const float fieldScales[TELEMETRY_FIELD_COUNT] = TELEMETRY_PACKED_SCALES;
+
+// Rounded and clamped above TELEMETRY_PACKED_NAN, which NaN maps to
+static int32_t TelemetryFixed(const telemetry_record_t *record, uint32_t field) {
+    float value;
+    memcpy(&value, (const uint8_t *)record + fieldOffsets[field], sizeof(value));
+
+    float v = value * fieldScales[field];
+    if (v != v) return TELEMETRY_PACKED_NAN;
+    if (v <= (float)(INT32_MIN + 1)) return INT32_MIN + 1;
+    if (v >= (float)INT32_MAX) return INT32_MAX;
+    return (int32_t)(v + (v >= 0.0f ? 0.5f : -0.5f));
+}
+
+static uint32_t TelemetryVarint(uint8_t *out, uint64_t value) {
+    uint32_t len = 0;
+    while (value >= 0x80u) {
+        out[len++] = (uint8_t)(value | 0x80u);
+        value >>= 7;
+    }
+    out[len++] = (uint8_t)value;
+    return len;
+}
+
+static uint64_t TelemetryZigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+void telemetry_encoder_reset(telemetry_encoder_t *enc) {
+    memset(enc, 0, sizeof(*enc));
+}
+
+uint32_t telemetry_encode(telemetry_encoder_t *enc, const telemetry_record_t *record, uint8_t *out) {
+    int32_t values[TELEMETRY_FIELD_COUNT];
+    uint32_t len = 1;
+
+    for (uint32_t i = 0; i < TELEMETRY_FIELD_COUNT; i++) {
+        values[i] = TelemetryFixed(record, i);
+    }
+
+    if (enc->since_keyframe == 0) {
+        len += TelemetryVarint(&out[len], record->timestamp_us);
+        for (uint32_t i = 0; i < TELEMETRY_FIELD_COUNT; i++) {
+            len += TelemetryVarint(&out[len], TelemetryZigzag(values[i]));
+        }
+        out[0] = (uint8_t)(TELEMETRY_PACKED_KEYFRAME | (len - 1));
+        enc->last_interval_us = 0;
+    } else {
+        int64_t interval = (int64_t)(record->timestamp_us - enc->last_timestamp_us);
+        len += TelemetryVarint(&out[len], TelemetryZigzag(interval - enc->last_interval_us));
+        enc->last_interval_us = interval;
+
+        uint32_t mask_at = len;
+        uint16_t mask = 0;
+        len += 2;
+        for (uint32_t i = 0; i < TELEMETRY_FIELD_COUNT; i++) {
+            if (values[i] != enc->last[i]) {
+                // Wrapping difference: the decoder adds it back modulo 2^32, so any pair of values round-trips
+                int32_t delta = (int32_t)((uint32_t)values[i] - (uint32_t)enc->last[i]);
+                len += TelemetryVarint(&out[len], TelemetryZigzag(delta));
+                mask |= (uint16_t)(1u << i);
+            }
+        }
+        out[mask_at] = (uint8_t)mask;
+        out[mask_at + 1] = (uint8_t)(mask >> 8);
+        out[0] = (uint8_t)(len - 1);
+    }
+
+    out[len] = crc8(out, len);
+    len++;
+
+    enc->last_timestamp_us = record->timestamp_us;
+    memcpy(enc->last, values, sizeof(enc->last));
+    if (++enc->since_keyframe >= TELEMETRY_KEYFRAME_INTERVAL) {
+        enc->since_keyframe = 0;
+    }
+    return len;
+}
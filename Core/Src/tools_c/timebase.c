@@ -0,0 +1,110 @@
+/*
+ * timebase.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#include "tools_h/timebase.h"
+#include "tools_h/configuration.h"
+
+// Upper 32 bits of the microsecond count, advanced by the TIM2 update interrupt
+static volatile uint32_t timebaseHigh;
+static bool lseLocked;
+
+#ifdef TIMEBASE_LSE_DISCIPLINE
+/*
+ * Start the LSE and let the MSI PLL-mode trim the MSI against it. The PLL
+ * and every timer derive from the MSI, so this disciplines TIM2 without
+ * any software correction. Falls back to the free-running MSI if the
+ * crystal does not start.
+ */
+static bool timebase_lock_lse(void) {
+    RCC->APB1ENR1 |= RCC_APB1ENR1_PWREN;
+    (void)RCC->APB1ENR1;
+    PWR->CR1 |= PWR_CR1_DBP;            // Backup domain write access for BDCR
+
+    if (!(RCC->BDCR & RCC_BDCR_LSERDY)) {
+        RCC->BDCR |= RCC_BDCR_LSEON;
+        uint32_t start = HAL_GetTick();
+        while (!(RCC->BDCR & RCC_BDCR_LSERDY)) {
+            if (HAL_GetTick() - start > TIMEBASE_LSE_TIMEOUT_MS) {
+                RCC->BDCR &= ~RCC_BDCR_LSEON;
+                return false;
+            }
+        }
+    }
+
+    RCC->CR |= RCC_CR_MSIPLLEN;
+    return true;
+}
+#endif
+
+void timebase_init(void) {
+    uint32_t timerClock = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+        timerClock *= 2;
+    }
+
+#ifdef TIMEBASE_LSE_DISCIPLINE
+    lseLocked = timebase_lock_lse();
+#endif
+
+    RCC->APB1ENR1 |= RCC_APB1ENR1_TIM2EN;
+    (void)RCC->APB1ENR1;
+
+    timebaseHigh = 0;
+    TIM2->CR1 = TIM_CR1_URS;
+    TIM2->PSC = timerClock / 1000000U - 1;
+    TIM2->ARR = 0xFFFFFFFFU;
+    TIM2->CNT = 0;
+    TIM2->EGR = TIM_EGR_UG;     // Load the prescaler (URS: no interrupt for this one)
+    TIM2->SR = 0;
+    TIM2->DIER = TIM_DIER_UIE;
+
+    // Above the sensor interrupts: the extension must be counted promptly
+    HAL_NVIC_SetPriority(TIM2_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(TIM2_IRQn);
+
+    TIM2->CR1 |= TIM_CR1_CEN;
+}
+
+void timebase_IRQHandler(void) {
+    if (TIM2->SR & TIM_SR_UIF) {
+        TIM2->SR = (uint32_t)~TIM_SR_UIF;
+        timebaseHigh++;
+    }
+}
+
+uint64_t timebase_us(void) {
+    uint32_t high, low;
+
+    do {
+        high = timebaseHigh;
+        low = TIM2->CNT;
+        // Wrapped but the interrupt has not run yet (masked or we preempted it)
+        if ((TIM2->SR & TIM_SR_UIF) && low < 0x80000000U) {
+            high++;
+        }
+    } while (high != timebaseHigh && !(TIM2->SR & TIM_SR_UIF));
+
+    return ((uint64_t)high << 32) | low;
+}
+
+uint32_t timebase_us32(void) {
+    return TIM2->CNT;
+}
+
+bool timebase_lse_locked(void) {
+    return lseLocked;
+}
+
+void timebase_split(uint64_t us, uint8_t *hour, uint8_t *min, uint8_t *sec, uint16_t *ms) {
+    uint32_t totalMs = (uint32_t)(us / 1000U);     // 49 days before this wraps
+    uint32_t totalSec = totalMs / 1000U;
+
+    *ms = (uint16_t)(totalMs % 1000U);
+    *sec = (uint8_t)(totalSec % 60U);
+    *min = (uint8_t)((totalSec / 60U) % 60U);
+    *hour = (uint8_t)((totalSec / 3600U) % 100U);
+}
@@ -0,0 +1,63 @@
+/*
+ * uart_stream.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#include "tools_h/uart_stream.h"
+
+bool uart_stream_init(UartStream *stream, UART_HandleTypeDef *huart, void *storage, uint32_t size) {
+    stream->huart = huart;
+    stream->in_flight = 0;
+    return ring_init(&stream->ring, storage, 1, size);
+}
+
+/*
+ * Runs from thread context and from the transfer complete interrupt:
+ * while in_flight is 0 no interrupt can come, and once it is set only
+ * the interrupt clears it.
+ */
+void uart_stream_kick(UartStream *stream) {
+    const uint8_t *data;
+    uint32_t n;
+
+    if (stream->in_flight != 0) {
+        return;
+    }
+    n = ring_peek(&stream->ring, &data);
+    if (n == 0) {
+        return;
+    }
+    if (n > UINT16_MAX) {
+        n = UINT16_MAX;
+    }
+    stream->in_flight = n;
+    if (HAL_UART_Transmit_DMA(stream->huart, (uint8_t *)data, (uint16_t)n) != HAL_OK) {
+        stream->in_flight = 0;
+    }
+}
+
+bool uart_stream_write(UartStream *stream, const void *data, uint32_t len) {
+    bool queued = ring_write(&stream->ring, data, len);
+    uart_stream_kick(stream);
+    return queued;
+}
+
+uint32_t uart_stream_pending(const UartStream *stream) {
+    return ring_count(&stream->ring);
+}
+
+void uart_stream_TxCpltCallback(UartStream *stream, UART_HandleTypeDef *huart) {
+    if (huart != stream->huart || stream->in_flight == 0) {
+        return;
+    }
+    ring_release(&stream->ring, stream->in_flight);
+    stream->in_flight = 0;
+    uart_stream_kick(stream);
+}
+
+// The run in flight is lost; carry on with what follows it
+void uart_stream_ErrorCallback(UartStream *stream, UART_HandleTypeDef *huart) {
+    uart_stream_TxCpltCallback(stream, huart);
+}
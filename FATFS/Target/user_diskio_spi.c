@@ -26,6 +26,8 @@
 
 #include "stm32l4xx_hal.h" /* Provide the low-level HAL functions */
 #include "user_diskio_spi.h"
+#include "tools_h/configuration.h"
+#include "tools_h/crc.h"
 
 //Make sure you set #define SD_SPI_HANDLE as some hspix in main.h
 //Make sure you set #define SD_CS_GPIO_Port as some GPIO port in main.h
@@ -35,8 +37,10 @@ extern SPI_HandleTypeDef SD_SPI_HANDLE;
 /* Function prototypes */
 
 //(Note that the _256 is used as a mask to clear the prescalar bits as it provides binary 111 in the correct position)
-#define FCLK_SLOW() { MODIFY_REG(SD_SPI_HANDLE.Instance->CR1, SPI_BAUDRATEPRESCALER_256, SPI_BAUDRATEPRESCALER_256); }	/* Set SCLK = slow, approx 280 KBits/s*/
-#define FCLK_FAST() { MODIFY_REG(SD_SPI_HANDLE.Instance->CR1, SPI_BAUDRATEPRESCALER_256, SPI_BAUDRATEPRESCALER_8); }	/* Set SCLK = fast, approx 4.5 MBits/s */
+//The fast clock is negotiated in USER_SPI_initialize from the card's CSD TRAN_SPEED and
+//SD_SPI_MAX_CLOCK_HZ, then stepped down one prescaler at a time on transfer errors.
+#define FCLK_SLOW() { MODIFY_REG(SD_SPI_HANDLE.Instance->CR1, SPI_BAUDRATEPRESCALER_256, SPI_BAUDRATEPRESCALER_256); }	/* Set SCLK = slow, PCLK/256 (~310 KBits/s) */
+#define FCLK_FAST() { MODIFY_REG(SD_SPI_HANDLE.Instance->CR1, SPI_BAUDRATEPRESCALER_256, (uint32_t)FastBR << SPI_CR1_BR_Pos); }	/* Set SCLK = PCLK / (2 << FastBR) */
 
 #define CS_HIGH()	{HAL_GPIO_WritePin(SPI2_CS_GPIO_Port, SPI2_CS_Pin, GPIO_PIN_SET);}
 #define CS_LOW()	{HAL_GPIO_WritePin(SPI2_CS_GPIO_Port, SPI2_CS_Pin, GPIO_PIN_RESET);}
@@ -83,6 +87,21 @@ DSTATUS Stat = STA_NOINIT;	/* Physical drive status */
 static
 BYTE CardType;			/* Card type flags */
 
+#define FAST_BR_FLOOR	5		/* Slowest rung of the fallback ladder: PCLK/64 (1.25 MBits/s at 80 MHz) */
+#define TRAN_SPEED_DEFAULT	25000000UL	/* Default-speed SD cards */
+
+static
+BYTE FastBR = 2;		/* CR1.BR of the data clock, PCLK/8 until negotiated */
+
+#if _USE_WRITE
+static
+BYTE StreamOpen;		/* 1: a CMD25 multi-block write is left open between calls */
+static
+DWORD StreamNext;		/* LBA the open stream continues at */
+static
+DWORD PreEraseStart, PreEraseEnd;	/* LBA region reserved with CTRL_STREAM_PREERASE */
+#endif
+
 uint32_t spiTimerTickStart;
 uint32_t spiTimerTickDelay;
 
@@ -111,28 +130,109 @@ BYTE xchg_spi (
 }
 
 
+/*-----------------------------------------------------------------------*/
+/* DMA data-block transfers                                              */
+/*-----------------------------------------------------------------------*/
+
+//Data blocks of SPI_DMA_MIN_BYTES or more are moved by the SPI2 DMA channels
+//(set up in HAL_SPI_MspInit). Shorter ones (CSD, SD status) stay on the polled
+//path where the DMA set-up would cost more than it saves. FatFs calls
+//disk_read/disk_write synchronously and the CRC and data-response bytes must
+//follow the block, so the caller still waits in spi_dma_wait() for the whole
+//transfer: the main loop gets no extra time. The wait sleeps in WFI instead of
+//spinning, so the core only wakes for the completion callback, the 1 ms
+//SysTick (timeout) and the barometer, ADC and UART interrupts, which are
+//serviced on time instead of stretching a byte-by-byte transfer.
+
+#define SPI_DMA_MIN_BYTES	64
+#define SPI_DMA_TIMEOUT		100		/* ms, a 512 byte block takes <1 ms even at the slow clock ladder steps */
+
+#define SPI_DMA_BUSY		0
+#define SPI_DMA_DONE		1
+#define SPI_DMA_ERROR		2
+
+static volatile BYTE spi_dma_state = SPI_DMA_DONE;
+static const BYTE spi_dummy_ff = 0xFF;	/* Clocked out repeatedly (MINC off) while receiving */
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+	if (hspi == &SD_SPI_HANDLE) spi_dma_state = SPI_DMA_DONE;
+}
+
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+	if (hspi == &SD_SPI_HANDLE) spi_dma_state = SPI_DMA_DONE;
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+	if (hspi == &SD_SPI_HANDLE) spi_dma_state = SPI_DMA_ERROR;
+}
+
+static
+int spi_dma_wait (void)	/* 1:OK, 0:Error or timeout */
+{
+	uint32_t start = HAL_GetTick();
+
+	while (spi_dma_state == SPI_DMA_BUSY) {
+		if ((HAL_GetTick() - start) >= SPI_DMA_TIMEOUT) {
+			HAL_SPI_Abort(&SD_SPI_HANDLE);
+			return 0;
+		}
+		//Masked so a completion between the test and WFI still wakes the core
+		//(a pending interrupt ends WFI even with PRIMASK set); it runs right after
+		__disable_irq();
+		if (spi_dma_state == SPI_DMA_BUSY) __WFI();
+		__enable_irq();
+	}
+	return spi_dma_state == SPI_DMA_DONE;
+}
+
+
 /* Receive multiple byte */
 static
-void rcvr_spi_multi (
+int rcvr_spi_multi (	/* 1:OK, 0:DMA error */
 	BYTE *buff,		/* Pointer to data buffer */
 	UINT btr		/* Number of bytes to receive (even number) */
 )
 {
-	for(UINT i=0; i<btr; i++) {
-		*(buff+i) = xchg_spi(0xFF);
+	if (btr < SPI_DMA_MIN_BYTES) {
+		for(UINT i=0; i<btr; i++) {
+			*(buff+i) = xchg_spi(0xFF);
+		}
+		return 1;
+	}
+
+	//TX channel must be disabled to modify CCR; HAL re-enables it on start
+	__HAL_DMA_DISABLE(SD_SPI_HANDLE.hdmatx);
+	CLEAR_BIT(SD_SPI_HANDLE.hdmatx->Instance->CCR, DMA_CCR_MINC);
+
+	spi_dma_state = SPI_DMA_BUSY;
+	if (HAL_SPI_TransmitReceive_DMA(&SD_SPI_HANDLE, &spi_dummy_ff, buff, (uint16_t)btr) != HAL_OK) {
+		spi_dma_state = SPI_DMA_ERROR;
+		return 0;
 	}
+	return spi_dma_wait();
 }
 
 
 #if _USE_WRITE
 /* Send multiple byte */
 static
-void xmit_spi_multi (
+int xmit_spi_multi (	/* 1:OK, 0:DMA error */
 	const BYTE *buff,	/* Pointer to the data */
 	UINT btx			/* Number of bytes to send (even number) */
 )
 {
-	HAL_SPI_Transmit(&SD_SPI_HANDLE, buff, btx, HAL_MAX_DELAY);
+	__HAL_DMA_DISABLE(SD_SPI_HANDLE.hdmatx);
+	SET_BIT(SD_SPI_HANDLE.hdmatx->Instance->CCR, DMA_CCR_MINC);
+
+	spi_dma_state = SPI_DMA_BUSY;
+	if (HAL_SPI_Transmit_DMA(&SD_SPI_HANDLE, buff, (uint16_t)btx) != HAL_OK) {
+		spi_dma_state = SPI_DMA_ERROR;
+		return 0;
+	}
+	return spi_dma_wait();
 }
 #endif
 
@@ -206,6 +306,7 @@ int rcvr_datablock (	/* 1:OK, 0:Error */
 )
 {
 	BYTE token;
+	WORD crc;
 
 
 	SPI_Timer_On(200);
@@ -215,8 +316,16 @@ int rcvr_datablock (	/* 1:OK, 0:Error */
 	} while ((token == 0xFF) && SPI_Timer_Status());
 	if(token != 0xFE) return 0;		/* Function fails if invalid DataStart token or timeout */
 
-	rcvr_spi_multi(buff, btr);		/* Store trailing data to the buffer */
-	xchg_spi(0xFF); xchg_spi(0xFF);			/* Discard CRC */
+	if (!rcvr_spi_multi(buff, btr)) return 0;	/* Store trailing data to the buffer */
+	crc = (WORD)xchg_spi(0xFF) << 8;	/* CRC16 of the data block */
+	crc |= xchg_spi(0xFF);
+
+#ifdef SD_SPI_READ_CRC_CHECK
+	//Only whole sectors: partial reads (ACMD13) are followed by data, not the CRC
+	if (btr == 512 && crc16_ccitt(buff, btr, 0) != crc) return 0;
+#else
+	(void)crc;
+#endif
 
 	return 1;						/* Function succeeded */
 }
@@ -241,7 +350,7 @@ int xmit_datablock (	/* 1:OK, 0:Failed */
 
 	xchg_spi(token);					/* Send token */
 	if (token != 0xFD) {				/* Send data if token is other than StopTran */
-		xmit_spi_multi(buff, 512);		/* Data */
+		if (!xmit_spi_multi(buff, 512)) return 0;	/* Data */
 		xchg_spi(0xFF); xchg_spi(0xFF);	/* Dummy CRC */
 
 		resp = xchg_spi(0xFF);				/* Receive data resp */
@@ -299,6 +408,81 @@ BYTE send_cmd (		/* Return value: R1 resp (bit7==1:Failed to send) */
 }
 
 
+/*-----------------------------------------------------------------------*/
+/* Write streaming                                                       */
+/*-----------------------------------------------------------------------*/
+
+//With SD_SPI_WRITE_STREAMING a CMD25 multi-block write stays open after
+//USER_SPI_write returns. A following write to the next sector just sends more
+//data blocks, with no command, no ACMD23 and no stop-token busy wait. Anything
+//else that needs the bus (read, ioctl, non-sequential write) closes the stream
+//first with the STOP_TRAN token.
+
+static
+int stream_close (void)	/* 1:OK, 0:Card did not take the stop token */
+{
+#if _USE_WRITE
+	int ok;
+
+	if (!StreamOpen) return 1;
+	StreamOpen = 0;
+	ok = xmit_datablock(0, 0xFD);	/* STOP_TRAN token */
+	despiselect();
+	return ok;
+#else
+	return 1;
+#endif
+}
+
+
+
+/*-----------------------------------------------------------------------*/
+/* SPI clock negotiation                                                 */
+/*-----------------------------------------------------------------------*/
+
+/* Decode the CSD TRAN_SPEED byte into a bit rate [bit/s] */
+static
+DWORD tran_speed_hz (
+	BYTE tran_speed		/* CSD[3] */
+)
+{
+	static const BYTE time_value_x10[16] = {0, 10, 12, 13, 15, 20, 25, 30, 35, 40, 45, 50, 55, 60, 70, 80};
+	static const DWORD rate_unit_div10[4] = {10000UL, 100000UL, 1000000UL, 10000000UL};	/* 100k, 1M, 10M, 100M / 10 */
+	BYTE unit = tran_speed & 0x07;
+	BYTE tv = (tran_speed >> 3) & 0x0F;
+
+	if (unit > 3 || tv == 0) return TRAN_SPEED_DEFAULT;	/* Reserved codes */
+	return time_value_x10[tv] * rate_unit_div10[unit];
+}
+
+
+/* Pick the fastest prescaler within both the card and the board limits */
+static
+void select_fast_clock (
+	DWORD card_hz		/* Maximum clock from the CSD */
+)
+{
+	DWORD limit = (card_hz < SD_SPI_MAX_CLOCK_HZ) ? card_hz : SD_SPI_MAX_CLOCK_HZ;
+	DWORD pclk = HAL_RCC_GetPCLK1Freq();
+	BYTE br = 0;
+
+	while (br < 7 && (pclk >> (br + 1)) > limit) br++;
+	FastBR = br;
+}
+
+
+/* Fallback ladder: one prescaler step slower after a CRC or response error */
+static
+int step_down_clock (void)	/* 1:Slowed down, retry, 0:Already at the floor */
+{
+	if (FastBR >= FAST_BR_FLOOR) return 0;
+	FastBR++;
+	FCLK_FAST();
+	return 1;
+}
+
+
+
 /*--------------------------------------------------------------------------
 
    Public FatFs Functions (wrapped in user_diskio.c)
@@ -320,13 +504,17 @@ inline DSTATUS USER_SPI_initialize (
 	BYTE drv		/* Physical drive number (0) */
 )
 {
-	BYTE n, cmd, ty, ocr[4];
+	BYTE n, cmd, ty, ocr[4], csd[16];
 
 	if (drv != 0) return STA_NOINIT;		/* Supports only drive 0 */
 	//assume SPI already init init_spi();	/* Initialize SPI */
 
 	if (Stat & STA_NODISK) return Stat;	/* Is card existing in the soket? */
 
+#if _USE_WRITE
+	StreamOpen = 0;
+	PreEraseStart = PreEraseEnd = 0;
+#endif
 	FCLK_SLOW();
 	for (n = 10; n; n--) xchg_spi(0xFF);	/* Send 80 dummy clocks */
 
@@ -354,6 +542,14 @@ inline DSTATUS USER_SPI_initialize (
 		}
 	}
 	CardType = ty;	/* Card type */
+
+	if (ty) {			/* Negotiate the data clock from TRAN_SPEED (still at the slow clock) */
+		if (send_cmd(CMD9, 0) == 0 && rcvr_datablock(csd, 16)) {
+			select_fast_clock(tran_speed_hz(csd[3]));
+		} else {
+			select_fast_clock(TRAN_SPEED_DEFAULT);
+		}
+	}
 	despiselect();
 
 	if (ty) {			/* OK */
@@ -387,16 +583,13 @@ inline DSTATUS USER_SPI_status (
 /* Read sector(s)                                                        */
 /*-----------------------------------------------------------------------*/
 
-inline DRESULT USER_SPI_read (
-	BYTE drv,		/* Physical drive number (0) */
+static
+UINT read_blocks (	/* Number of sectors not read (0:OK) */
 	BYTE *buff,		/* Pointer to the data buffer to store read data */
 	DWORD sector,	/* Start sector number (LBA) */
 	UINT count		/* Number of sectors to read (1..128) */
 )
 {
-	if (drv || !count) return RES_PARERR;		/* Check parameter */
-	if (Stat & STA_NOINIT) return RES_NOTRDY;	/* Check if drive is ready */
-
 	if (!(CardType & CT_BLOCK)) sector *= 512;	/* LBA ot BA conversion (byte addressing cards) */
 
 	if (count == 1) {	/* Single sector read */
@@ -416,7 +609,25 @@ inline DRESULT USER_SPI_read (
 	}
 	despiselect();
 
-	return count ? RES_ERROR : RES_OK;	/* Return result */
+	return count;
+}
+
+inline DRESULT USER_SPI_read (
+	BYTE drv,		/* Physical drive number (0) */
+	BYTE *buff,		/* Pointer to the data buffer to store read data */
+	DWORD sector,	/* Start sector number (LBA) */
+	UINT count		/* Number of sectors to read (1..128) */
+)
+{
+	if (drv || !count) return RES_PARERR;		/* Check parameter */
+	if (Stat & STA_NOINIT) return RES_NOTRDY;	/* Check if drive is ready */
+	if (!stream_close()) return RES_ERROR;
+
+	while (read_blocks(buff, sector, count)) {	/* Retry the whole request one clock step lower */
+		if (!step_down_clock()) return RES_ERROR;
+	}
+
+	return RES_OK;
 }
 
 
@@ -426,17 +637,39 @@ inline DRESULT USER_SPI_read (
 /*-----------------------------------------------------------------------*/
 
 #if _USE_WRITE
-inline DRESULT USER_SPI_write (
-	BYTE drv,			/* Physical drive number (0) */
+static
+UINT write_blocks (	/* Number of sectors not written (0:OK) */
 	const BYTE *buff,	/* Ponter to the data to write */
 	DWORD sector,		/* Start sector number (LBA) */
 	UINT count			/* Number of sectors to write (1..128) */
 )
 {
-	if (drv || !count) return RES_PARERR;		/* Check parameter */
-	if (Stat & STA_NOINIT) return RES_NOTRDY;	/* Check drive status */
-	if (Stat & STA_PROTECT) return RES_WRPRT;	/* Check write protect */
+#ifdef SD_SPI_WRITE_STREAMING
+	if (!StreamOpen || sector != StreamNext) {	/* Start a new stream */
+		DWORD n = count;
+		if (!stream_close()) return count;
+		if (CardType & CT_SDC) {
+			if (sector >= PreEraseStart && sector < PreEraseEnd) n = PreEraseEnd - sector;	/* Pre-erase up to the end of the region */
+			send_cmd(ACMD23, (n > 0x7FFFFF) ? 0x7FFFFF : n);
+		}
+		if (send_cmd(CMD25, (CardType & CT_BLOCK) ? sector : sector * 512) != 0) {	/* WRITE_MULTIPLE_BLOCK */
+			despiselect();
+			return count;
+		}
+		StreamOpen = 1;
+		StreamNext = sector;
+	}
+	do {
+		if (!xmit_datablock(buff, 0xFC)) {
+			stream_close();
+			return count;
+		}
+		buff += 512;
+		StreamNext++;
+	} while (--count);
 
+	return 0;	/* Card stays selected, the stream is closed by the next non-sequential access */
+#else
 	if (!(CardType & CT_BLOCK)) sector *= 512;	/* LBA ==> BA conversion (byte addressing cards) */
 
 	if (count == 1) {	/* Single sector write */
@@ -457,7 +690,26 @@ inline DRESULT USER_SPI_write (
 	}
 	despiselect();
 
-	return count ? RES_ERROR : RES_OK;	/* Return result */
+	return count;
+#endif
+}
+
+inline DRESULT USER_SPI_write (
+	BYTE drv,			/* Physical drive number (0) */
+	const BYTE *buff,	/* Ponter to the data to write */
+	DWORD sector,		/* Start sector number (LBA) */
+	UINT count			/* Number of sectors to write (1..128) */
+)
+{
+	if (drv || !count) return RES_PARERR;		/* Check parameter */
+	if (Stat & STA_NOINIT) return RES_NOTRDY;	/* Check drive status */
+	if (Stat & STA_PROTECT) return RES_WRPRT;	/* Check write protect */
+
+	while (write_blocks(buff, sector, count)) {	/* Retry the whole request one clock step lower */
+		if (!step_down_clock()) return RES_ERROR;
+	}
+
+	return RES_OK;
 }
 #endif
 
@@ -480,6 +732,7 @@ inline DRESULT USER_SPI_ioctl (
 
 	if (drv) return RES_PARERR;					/* Check parameter */
 	if (Stat & STA_NOINIT) return RES_NOTRDY;	/* Check if drive is ready */
+	if (!stream_close()) return RES_ERROR;
 
 	res = RES_ERROR;
 
@@ -524,6 +777,24 @@ inline DRESULT USER_SPI_ioctl (
 		}
 		break;
 
+	case MMC_GET_CSD :	/* Read CSD (16 bytes) */
+		if ((send_cmd(CMD9, 0) == 0) && rcvr_datablock(buff, 16)) res = RES_OK;
+		break;
+
+#if _USE_WRITE
+	case CTRL_STREAM_PREERASE :	/* Erase a region and pre-erase hint it to streamed writes */
+		dp = buff;
+		PreEraseStart = dp[0]; PreEraseEnd = dp[0] + dp[1];
+		if (!dp[1]) {
+			res = RES_OK;
+			break;
+		}
+		st = dp[0]; ed = dp[0] + dp[1] - 1;
+		despiselect();
+		if (USER_SPI_ioctl(drv, CTRL_TRIM, (DWORD[2]){st, ed}) == RES_OK) res = RES_OK;
+		break;
+#endif
+
 	case CTRL_TRIM :	/* Erase a block of sectors (used when _USE_ERASE == 1) */
 		if (!(CardType & CT_SDC)) break;				/* Check if the card is SDC */
 		if (USER_SPI_ioctl(drv, MMC_GET_CSD, csd)) break;	/* Get CSD */
@@ -546,3 +817,13 @@ inline DRESULT USER_SPI_ioctl (
 	return res;
 }
 #endif
+
+
+/*-----------------------------------------------------------------------*/
+/* Negotiated data clock                                                 */
+/*-----------------------------------------------------------------------*/
+
+DWORD USER_SPI_clock_hz (void)
+{
+	return HAL_RCC_GetPCLK1Freq() >> (FastBR + 1);
+}
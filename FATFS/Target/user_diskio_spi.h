@@ -36,4 +36,10 @@ extern DRESULT USER_SPI_read (BYTE pdrv, BYTE *buff, DWORD sector, UINT count);
   extern DRESULT USER_SPI_ioctl (BYTE pdrv, BYTE cmd, void *buff);
 #endif /* _USE_IOCTL == 1 */
 
+/* Driver specific disk_ioctl() codes */
+#define CTRL_STREAM_PREERASE	60	/* DWORD[2] {start LBA, count}: erase the region and use it as ACMD23 pre-erase hint, count 0 clears */
+
+/* SPI clock currently used for data transfers [Hz] (negotiated at initialization) */
+extern DWORD USER_SPI_clock_hz (void);
+
 #endif
@@ -0,0 +1,267 @@
+/*
+ * flight_bench.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ *
+ * Replays a synthetic flight through the unmodified manager phases on the
+ * host and reports, per phase, host CPU time, simulated flight time and SD
+ * traffic. Firmware console output (host printf, and the buffered console
+ * on the emulated USART2) is discarded unless -v is given.
+ *
+ *   flight_bench [-g ground_s] [-a apogee_m] [-u ascent_mps] [-d descent_mps]
+ *                [-i sdcard.img] [-l downlink.bin] [-f n] [-v]
+ *
+ * -l writes the telemetry downlink (USART1) to a file, a FIFO or a pty for
+ * Tools/downlink_rx.py. -f fails every n-th SD write command after the card
+ * is formatted, to check that the files still decode.
+ */
+
+#include "host.h"
+#include "fatfs.h"
+#include "drivers_h/black_box.h"
+#include "drivers_h/sds011.h"
+#include "tools_h/global_variables.h"
+#include "tools_h/telemetry.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DISK_SECTORS   (64UL * 1024 * 1024 / 512)
+#define TIMEOUT_S      120.0   // Simulated time allowed past the end of the profile
+#define CONSOLE_DRAIN_US 250000  // A full console buffer at 115200 baud, let out after each phase with -v
+
+PhaseResult init_phase(void);
+PhaseResult pre_flight_phase(void);
+PhaseResult flight_phase(void);
+PhaseResult post_flight_phase(void);
+
+extern SDS sds011_device;
+
+typedef struct {
+    const char *name;
+    PhaseResult (*run)(void);
+} phase_t;
+
+static const phase_t phases[] = {
+    { "init",        init_phase },
+    { "pre-flight",  pre_flight_phase },
+    { "flight",      flight_phase },
+    { "post-flight", post_flight_phase },
+};
+
+static uint64_t deadline_us;
+static FILE *downlink_out;
+static int verbose;
+static int saved_stdout = -1;
+
+static void watchdog(uint64_t now_us) {
+    if (now_us > deadline_us && system_state != STATUS_ERROR) {
+        system_state = STATUS_ERROR;
+    }
+}
+
+// The firmware console, as it would come out of the ST-LINK virtual COM port,
+// and the downlink as the radio would get it
+static void uart_sink(int uart, const uint8_t *data, uint16_t len) {
+    if (uart == 2 && verbose) {
+        fwrite(data, 1, len, stdout);
+    } else if (uart == 1 && downlink_out) {
+        fwrite(data, 1, len, downlink_out);
+    }
+}
+
+static double wall_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void quiet(int on) {
+    fflush(stdout);
+    if (on) {
+        int null = open("/dev/null", O_WRONLY);
+        saved_stdout = dup(STDOUT_FILENO);
+        dup2(null, STDOUT_FILENO);
+        close(null);
+    } else if (saved_stdout >= 0) {
+        dup2(saved_stdout, STDOUT_FILENO);
+        close(saved_stdout);
+        saved_stdout = -1;
+    }
+}
+
+// Packed files (TELEMETRY_BIN_VERSION_PACKED) have no fixed record size: walk the length bytes
+static unsigned long count_packed_records(const char *path) {
+    FIL fil;
+    UINT br;
+    uint8_t buf[512];
+    unsigned long records = 0;
+    uint32_t skip = sizeof(telemetry_bin_header_t);
+
+    if (f_open(&fil, path, FA_READ) != FR_OK) {
+        return 0;
+    }
+    while (f_read(&fil, buf, sizeof(buf), &br) == FR_OK && br > 0) {
+        for (uint32_t i = 0; i < br; i++) {
+            if (skip > 0) {
+                skip--;
+                continue;
+            }
+            skip = (buf[i] & 0x7Fu) + 1;   // Body and CRC
+            records++;
+        }
+    }
+    f_close(&fil);
+    return records;
+}
+
+static void list_files(void) {
+    FATFS fs_check;
+    DIR dir;
+    FILINFO fno;
+
+    if (f_mount(&fs_check, "0:/", 1) != FR_OK || f_opendir(&dir, "/") != FR_OK) {
+        printf("  (cannot remount the disk)\n");
+        return;
+    }
+    while (f_readdir(&dir, &fno) == FR_OK && fno.fname[0]) {
+        const char *ext = strrchr(fno.fname, '.');
+        bool telemetry = strncmp(fno.fname, "telemetry", 9) == 0 || strncmp(fno.fname, "TELEMETRY", 9) == 0;
+        printf("  %-20s %10lu bytes", fno.fname, (unsigned long)fno.fsize);
+        if (telemetry && ext && (strcmp(ext, ".bin") == 0 || strcmp(ext, ".BIN") == 0) && fno.fsize > sizeof(telemetry_bin_header_t)) {
+            telemetry_bin_header_t header;
+            FIL fil;
+            UINT br = 0;
+            if (f_open(&fil, fno.fname, FA_READ) == FR_OK) {
+                f_read(&fil, &header, sizeof(header), &br);
+                f_close(&fil);
+            }
+            if (br == sizeof(header) && header.version == TELEMETRY_BIN_VERSION_PACKED) {
+                unsigned long records = count_packed_records(fno.fname);
+                printf("  (%lu records, %.1f bytes each)", records,
+                       records ? (double)(fno.fsize - sizeof(header)) / records : 0.0);
+            } else {
+                printf("  (%lu records)", (unsigned long)((fno.fsize - sizeof(telemetry_bin_header_t)) / sizeof(telemetry_record_t)));
+            }
+        }
+        printf("\n");
+    }
+    f_closedir(&dir);
+    f_mount(NULL, "0:/", 1);
+}
+
+int main(int argc, char **argv) {
+    host_flight_t flight = {
+        .ground_s = 10.0, .ascent_rate = 20.0, .apogee_m = 2000.0,
+        .descent_rate = 10.0, .pad_pressure = 101325.0,
+    };
+    const char *image = NULL;
+    uint32_t fail_every = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "g:a:u:d:i:l:f:v")) != -1) {
+        switch (opt) {
+        case 'g': flight.ground_s = atof(optarg); break;
+        case 'a': flight.apogee_m = atof(optarg); break;
+        case 'u': flight.ascent_rate = atof(optarg); break;
+        case 'd': flight.descent_rate = atof(optarg); break;
+        case 'i': image = optarg; break;
+        case 'l':
+            if (!(downlink_out = fopen(optarg, "wb"))) {
+                perror(optarg);
+                return 1;
+            }
+            break;
+        case 'f': fail_every = (uint32_t)atol(optarg); break;
+        case 'v': verbose = 1; break;
+        default:
+            fprintf(stderr, "usage: %s [-g ground_s] [-a apogee_m] [-u ascent_mps] [-d descent_mps] [-i sdcard.img] [-l downlink.bin] [-f n] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    host_flight_set(&flight);
+    deadline_us = (uint64_t)((host_flight_duration_s() + TIMEOUT_S) * 1e6);
+    host_set_tick_hook(watchdog);
+    host_set_uart_tx_sink(uart_sink);
+
+    static BYTE work[4096];
+    if (host_disk_create(DISK_SECTORS) != 0) {
+        fprintf(stderr, "cannot allocate the RAM disk\n");
+        return 1;
+    }
+    MX_FATFS_Init();
+    if (f_mkfs(USERPath, FM_ANY, 0, work, sizeof(work)) != FR_OK) {
+        fprintf(stderr, "f_mkfs failed\n");
+        return 1;
+    }
+    host_disk_fail_writes(fail_every);
+
+    printf("Synthetic flight: %.0f s on the pad, %.0f m apogee, %.1f m/s up, %.1f m/s down (%.0f s)\n\n",
+           flight.ground_s, flight.apogee_m, flight.ascent_rate, flight.descent_rate, host_flight_duration_s());
+    printf("%-12s %-8s %10s %10s %12s %10s %10s\n",
+           "phase", "result", "cpu ms", "sim s", "SD bytes", "SD writes", "SD busy s");
+
+    host_disk_stats_t total = { 0 };
+    int failed = 0;
+    for (size_t i = 0; i < sizeof(phases) / sizeof(phases[0]); i++) {
+        host_disk_stats_t before, after;
+        host_disk_get_stats(&before);
+        uint64_t sim_start = host_time_us();
+        double t0 = wall_ms();
+
+        if (!verbose) quiet(1);
+        PhaseResult res = phases[i].run();
+        if (!verbose) quiet(0);
+
+        double cpu = wall_ms() - t0;
+        host_disk_get_stats(&after);
+        uint64_t sim_us = host_time_us() - sim_start;
+        if (verbose) {
+            host_advance_us(CONSOLE_DRAIN_US);
+        }
+        printf("%-12s %-8s %10.1f %10.2f %12llu %10llu %10.2f\n",
+               phases[i].name,
+               system_state == STATUS_ERROR ? "TIMEOUT" : res == PHASE_SUCCESS ? "ok" : "FAIL",
+               cpu, sim_us / 1e6,
+               (unsigned long long)((after.sectors_written - before.sectors_written) * 512),
+               (unsigned long long)(after.write_calls - before.write_calls),
+               (after.busy_us - before.busy_us) / 1e6);
+        total = after;
+
+        if (res != PHASE_SUCCESS || system_state == STATUS_ERROR) {
+            failed = 1;
+            break;
+        }
+    }
+
+    host_sensor_stats_t sensors;
+    host_sensor_get_stats(&sensors);
+    printf("\nTotal: %.2f s simulated, %llu bytes in %llu SD writes, %llu bytes read\n",
+           host_time_us() / 1e6, (unsigned long long)(total.sectors_written * 512),
+           (unsigned long long)total.write_calls, (unsigned long long)(total.sectors_read * 512));
+    if (fail_every) {
+        printf("SD write commands failed on purpose: %llu\n", (unsigned long long)total.write_errors);
+    }
+    printf("MS5607: %u conversions, %u early ADC reads; I2C: %u transfers\n",
+           sensors.ms5607_conversions, sensors.ms5607_early_reads, sensors.i2c_transfers);
+    printf("SDS011: %u frames sent (%u corrupted, %u stray bytes); driver: %lu accepted, %lu checksum errors, %lu bytes skipped\n",
+           sensors.sds011_frames, sensors.sds011_corrupted, sensors.sds011_stray_bytes,
+           (unsigned long)sds011_device.frames_ok, (unsigned long)sds011_device.checksum_errors,
+           (unsigned long)sds011_device.resyncs);
+    printf("\nFiles:\n");
+    list_files();
+
+    if (downlink_out) {
+        fclose(downlink_out);
+    }
+    if (image && host_disk_save(image) != 0) {
+        fprintf(stderr, "cannot write %s\n", image);
+        return 1;
+    }
+    return failed;
+}
@@ -0,0 +1,568 @@
+/*
+ * hal_stub.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ *
+ * HAL entry points, peripheral handles and interrupt emulation for the host
+ * build. The clock is kept in nanoseconds so byte-level bus timings add up.
+ */
+
+#include "stm32l4xx_hal.h"
+#include "host.h"
+#include "sensors.h"
+
+#define APB1_TIMER_CLOCK_HZ  80000000ULL
+#define APB2_TIMER_CLOCK_HZ  80000000ULL
+#define SPI1_CLOCK_HZ        10000000ULL   // PCLK2 / 8
+#define I2C3_CLOCK_HZ        100000ULL
+#define USART3_BAUD          9600ULL
+#define USART1_BAUD          115200ULL
+#define USART2_BAUD          115200ULL
+
+// Peripheral handles normally defined by main.c
+SPI_HandleTypeDef hspi1 = { .State = HAL_SPI_STATE_READY };
+SPI_HandleTypeDef hspi2 = { .State = HAL_SPI_STATE_READY };
+I2C_HandleTypeDef hi2c3 = { .State = HAL_I2C_STATE_READY };
+UART_HandleTypeDef huart1;
+UART_HandleTypeDef huart2;
+UART_HandleTypeDef huart3;
+ADC_HandleTypeDef hadc1;
+
+GPIO_TypeDef host_gpio[3];
+TIM_TypeDef  host_tim6;
+TIM_TypeDef  host_tim15;
+RCC_TypeDef  host_rcc;
+PWR_TypeDef  host_pwr;
+CoreDebug_Type host_core_debug;
+ITM_Type     host_itm;
+uint32_t SystemCoreClock = 80000000;
+
+static DWT_Type host_dwt_regs;
+static TIM_TypeDef host_tim2_regs;
+
+void TIM2_IRQHandler(void);
+void TIM6_DAC_IRQHandler(void);
+
+static uint64_t now_ns;
+static int irq_depth;
+static void (*tick_hook)(uint64_t now_us);
+
+// TIM2 (free-running up-counter, started by setting CEN)
+static bool tim2_running;
+static uint64_t tim2_start_ns;
+static uint64_t tim2_updates;
+
+// TIM6 (one-pulse, started by setting CEN)
+static bool tim6_armed;
+static uint64_t tim6_due_ns;
+
+// I2C3 interrupt-driven memory read, completed when the bus time has elapsed
+static bool i2c3_pending;
+static uint64_t i2c3_due_ns;
+static struct {
+    uint16_t address;
+    uint8_t  reg;
+    uint8_t *data;
+    uint16_t size;
+} i2c3_xfer;
+
+// USART3 reception to idle into a circular DMA buffer
+static DMA_HandleTypeDef hdma_usart3_rx;
+static uint8_t *uart3_rx_buf;
+static uint16_t uart3_rx_size;
+static uint16_t uart3_rx_count;
+static bool uart3_idle_armed;
+static uint64_t uart3_idle_due_ns;
+
+// UART transmission by DMA, completed when the last byte is on the line
+typedef struct {
+    UART_HandleTypeDef *huart;
+    int number;
+    uint64_t baud;
+    DMA_HandleTypeDef hdma;
+    bool pending;
+    uint64_t due_ns;
+    const uint8_t *data;
+    uint16_t size;
+} uart_tx_t;
+
+static uart_tx_t uart_tx[] = {
+    { .huart = &huart1, .number = 1, .baud = USART1_BAUD },
+    { .huart = &huart2, .number = 2, .baud = USART2_BAUD },
+};
+#define UART_TX_COUNT (sizeof(uart_tx) / sizeof(uart_tx[0]))
+
+static uart_tx_t *uart_tx_due;
+static void (*uart_tx_sink)(int uart, const uint8_t *data, uint16_t len);
+
+// ADC1 converting on TIM15 TRGO into a circular DMA buffer. Only the
+// half/full transfer events are scheduled; each fills its half on delivery.
+static uint16_t *adc1_buf;
+static uint32_t adc1_len;
+static uint32_t adc1_full_scale;
+static bool adc1_running;
+static uint64_t adc1_start_ns;
+static uint64_t adc1_period_ns;
+static uint64_t adc1_conversions;
+static uint64_t adc1_due_ns;
+
+/* ========================== */
+/*   CLOCK AND INTERRUPTS     */
+/* ========================== */
+
+static void irq_enter(void) { irq_depth++; }
+static void irq_exit(void)  { irq_depth--; }
+
+static void tim6_check_start(void) {
+    if ((TIM6->CR1 & TIM_CR1_CEN) && !tim6_armed) {
+        uint64_t ticks = (uint64_t)(TIM6->ARR + 1) * (TIM6->PSC + 1);
+        tim6_armed = true;
+        tim6_due_ns = now_ns + ticks * 1000000000ULL / APB1_TIMER_CLOCK_HZ;
+    }
+}
+
+static void tim6_fire(void) {
+    tim6_armed = false;
+    if (TIM6->CR1 & TIM_CR1_OPM) {
+        TIM6->CR1 &= ~TIM_CR1_CEN;
+    }
+    TIM6->SR |= TIM_SR_UIF;
+    if (TIM6->DIER & TIM_DIER_UIE) {
+        irq_enter();
+        TIM6_DAC_IRQHandler();
+        irq_exit();
+    }
+}
+
+static uint64_t tim2_ticks(void) {
+    uint64_t ns_per_tick = 1000000000ULL * (host_tim2_regs.PSC + 1) / APB1_TIMER_CLOCK_HZ;
+    return (now_ns - tim2_start_ns) / ns_per_tick;
+}
+
+// Raise the update event for every 2^32 wrap since the last check
+static void tim2_check(void) {
+    if (!(host_tim2_regs.CR1 & TIM_CR1_CEN)) {
+        tim2_running = false;
+        return;
+    }
+    if (!tim2_running) {
+        tim2_running = true;
+        tim2_start_ns = now_ns - (uint64_t)host_tim2_regs.CNT * 1000000000ULL
+                                 * (host_tim2_regs.PSC + 1) / APB1_TIMER_CLOCK_HZ;
+        tim2_updates = 0;
+        return;
+    }
+    uint64_t updates = tim2_ticks() >> 32;
+    if (updates != tim2_updates) {
+        tim2_updates = updates;
+        host_tim2_regs.SR |= TIM_SR_UIF;
+        if (host_tim2_regs.DIER & TIM_DIER_UIE) {
+            irq_enter();
+            TIM2_IRQHandler();
+            irq_exit();
+        }
+    }
+}
+
+static void adc1_schedule(void) {
+    adc1_due_ns = adc1_start_ns + (adc1_conversions + adc1_len / 2) * adc1_period_ns;
+}
+
+// Conversions start on the first TIM15 update after both the DMA and the timer run
+static void adc1_check_start(void) {
+    bool triggering = adc1_buf && (TIM15->CR1 & TIM_CR1_CEN) && (TIM15->CR2 & TIM_CR2_MMS_1);
+
+    if (triggering && !adc1_running) {
+        adc1_running = true;
+        adc1_period_ns = (uint64_t)(TIM15->ARR + 1) * (TIM15->PSC + 1) * 1000000000ULL / APB2_TIMER_CLOCK_HZ;
+        adc1_start_ns = now_ns + adc1_period_ns;
+        adc1_conversions = 0;
+        adc1_schedule();
+    } else if (!triggering) {
+        adc1_running = false;
+    }
+}
+
+static void adc1_half_complete(void) {
+    uint32_t first = (uint32_t)(adc1_conversions % adc1_len);
+
+    for (uint32_t i = 0; i < adc1_len / 2; i++) {
+        uint64_t at_ns = adc1_start_ns + (adc1_conversions + i) * adc1_period_ns;
+        adc1_buf[first + i] = mics5524_model_sample(at_ns, adc1_full_scale);
+    }
+    adc1_conversions += adc1_len / 2;
+    adc1_schedule();
+
+    irq_enter();
+    if (first == 0) {
+        HAL_ADC_ConvHalfCpltCallback(&hadc1);
+    } else {
+        HAL_ADC_ConvCpltCallback(&hadc1);
+    }
+    irq_exit();
+}
+
+static uint64_t bytes_ns(uint32_t bytes, uint32_t bits_per_byte, uint64_t clock_hz);
+
+static void uart3_rx_event(uint16_t pos) {
+    irq_enter();
+    HAL_UARTEx_RxEventCallback(&huart3, pos);
+    irq_exit();
+}
+
+// Bytes arriving while no reception is armed are lost. The idle event fires
+// once the line has been quiet for a character time after the last byte.
+static void uart3_deliver(uint64_t until_ns) {
+    uint64_t at_ns;
+    uint8_t byte;
+
+    for (;;) {
+        uint64_t next_byte_ns = sds011_model_next_ns();
+        if (uart3_idle_armed && uart3_idle_due_ns <= until_ns && uart3_idle_due_ns < next_byte_ns) {
+            if (now_ns < uart3_idle_due_ns) now_ns = uart3_idle_due_ns;
+            uart3_idle_armed = false;
+            if (uart3_rx_buf) uart3_rx_event(uart3_rx_count);
+            continue;
+        }
+        if (!sds011_model_rx(until_ns, &at_ns, &byte)) break;
+
+        if (now_ns < at_ns) now_ns = at_ns;
+        uart3_idle_armed = true;
+        uart3_idle_due_ns = at_ns + bytes_ns(1, 11, USART3_BAUD);
+        if (!uart3_rx_buf) continue;
+        uart3_rx_buf[uart3_rx_count++] = byte;
+        if (uart3_rx_count == uart3_rx_size) {
+            uart3_rx_count = 0;         // Circular: keep receiving from the start
+            uart3_rx_event(uart3_rx_size);
+        }
+    }
+}
+
+static void uart_tx_complete(void) {
+    uart_tx_t *tx = uart_tx_due;
+    tx->pending = false;
+    irq_enter();
+    if (uart_tx_sink) uart_tx_sink(tx->number, tx->data, tx->size);
+    HAL_UART_TxCpltCallback(tx->huart);
+    irq_exit();
+}
+
+static void i2c3_complete(void) {
+    bool ok = i2c_model_mem_read(i2c3_xfer.address, i2c3_xfer.reg, i2c3_xfer.data, i2c3_xfer.size, now_ns);
+
+    i2c3_pending = false;
+    hi2c3.State = HAL_I2C_STATE_READY;
+    irq_enter();
+    if (ok) {
+        HAL_I2C_MemRxCpltCallback(&hi2c3);
+    } else {
+        HAL_I2C_ErrorCallback(&hi2c3);
+    }
+    irq_exit();
+}
+
+static void advance_ns(uint64_t ns) {
+    uint64_t target = now_ns + ns;
+
+    if (irq_depth > 0) {
+        // Inside an emulated ISR: time passes, nothing else may preempt
+        now_ns = target;
+        return;
+    }
+
+    for (;;) {
+        uint64_t next = target;
+        void (*event)(void) = NULL;
+
+        tim6_check_start();
+        if (tim6_armed && tim6_due_ns <= next) {
+            next = tim6_due_ns;
+            event = tim6_fire;
+        }
+        if (i2c3_pending && i2c3_due_ns <= next) {
+            next = i2c3_due_ns;
+            event = i2c3_complete;
+        }
+        adc1_check_start();
+        if (adc1_running && adc1_due_ns <= next) {
+            next = adc1_due_ns;
+            event = adc1_half_complete;
+        }
+        for (size_t i = 0; i < UART_TX_COUNT; i++) {
+            if (uart_tx[i].pending && uart_tx[i].due_ns <= next) {
+                next = uart_tx[i].due_ns;
+                event = uart_tx_complete;
+                uart_tx_due = &uart_tx[i];
+            }
+        }
+        uart3_deliver(next);
+        if (!event) break;
+        if (now_ns < next) now_ns = next;
+        event();
+    }
+    if (now_ns < target) now_ns = target;
+    tim2_check();
+
+    if (tick_hook) tick_hook(now_ns / 1000);
+}
+
+DWT_Type *host_dwt(void) {
+    host_dwt_regs.CYCCNT = (uint32_t)(now_ns * (SystemCoreClock / 1000000) / 1000);
+    return &host_dwt_regs;
+}
+
+TIM_TypeDef *host_tim2(void) {
+    advance_ns(HOST_TIMER_READ_NS);
+    if (!(host_tim2_regs.CR1 & TIM_CR1_CEN)) {
+        tim2_running = false;
+    } else if (!tim2_running) {
+        tim2_check();
+    } else {
+        host_tim2_regs.CNT = (uint32_t)tim2_ticks();
+    }
+    return &host_tim2_regs;
+}
+
+uint64_t host_time_us(void) {
+    return now_ns / 1000;
+}
+
+void host_advance_us(uint64_t us) {
+    advance_ns(us * 1000);
+}
+
+void host_set_tick_hook(void (*hook)(uint64_t now_us)) {
+    tick_hook = hook;
+}
+
+void host_set_uart_tx_sink(void (*sink)(int uart, const uint8_t *data, uint16_t len)) {
+    uart_tx_sink = sink;
+}
+
+static uint64_t bytes_ns(uint32_t bytes, uint32_t bits_per_byte, uint64_t clock_hz) {
+    return (uint64_t)bytes * bits_per_byte * 1000000000ULL / clock_hz;
+}
+
+/* ========================== */
+/*       CORE AND CLOCKS      */
+/* ========================== */
+
+uint32_t HAL_GetTick(void) {
+    advance_ns(HOST_TICK_COST_US * 1000);
+    return (uint32_t)(now_ns / 1000000);
+}
+
+void HAL_Delay(uint32_t Delay) {
+    advance_ns((uint64_t)Delay * 1000000);
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void) {
+    return (uint32_t)APB1_TIMER_CLOCK_HZ;
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq(void) {
+    return (uint32_t)APB2_TIMER_CLOCK_HZ;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority) {
+    UNUSED(IRQn); UNUSED(PreemptPriority); UNUSED(SubPriority);
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) {
+    UNUSED(IRQn);
+}
+
+// Interrupts are only delivered while time advances, never in between two statements
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn) {
+    UNUSED(IRQn);
+}
+
+/* ========================== */
+/*            GPIO            */
+/* ========================== */
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+    if (PinState == GPIO_PIN_SET) {
+        GPIOx->ODR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+    if (GPIOx == GPIOA && GPIO_Pin == GPIO_PIN_4) {
+        ms5607_model_select(PinState == GPIO_PIN_RESET, now_ns);
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    return (GPIOx->ODR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+/* ========================== */
+/*             SPI            */
+/* ========================== */
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    UNUSED(Timeout);
+    if (hspi != &hspi1) return HAL_ERROR;
+    ms5607_model_transfer(pData, NULL, Size, now_ns);
+    advance_ns(bytes_ns(Size, 8, SPI1_CLOCK_HZ));
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    UNUSED(Timeout);
+    if (hspi != &hspi1) return HAL_ERROR;
+    ms5607_model_transfer(NULL, pData, Size, now_ns);
+    advance_ns(bytes_ns(Size, 8, SPI1_CLOCK_HZ));
+    return HAL_OK;
+}
+
+/* ========================== */
+/*             I2C            */
+/* ========================== */
+
+// Address byte + data bytes, 9 clocks each (ACK included)
+static void i2c_time(uint16_t bytes) {
+    advance_ns(bytes_ns(bytes + 1, 9, I2C3_CLOCK_HZ));
+}
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout) {
+    UNUSED(Trials); UNUSED(Timeout);
+    if (hi2c != &hi2c3) return HAL_ERROR;
+    if (hi2c->State != HAL_I2C_STATE_READY) return HAL_BUSY;
+    i2c_time(0);
+    return i2c_model_present(DevAddress) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    UNUSED(Timeout);
+    if (hi2c != &hi2c3) return HAL_ERROR;
+    if (hi2c->State != HAL_I2C_STATE_READY) return HAL_BUSY;
+    i2c_time(Size);
+    return i2c_model_write(DevAddress, pData, Size, now_ns) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    UNUSED(Timeout);
+    if (hi2c != &hi2c3) return HAL_ERROR;
+    if (hi2c->State != HAL_I2C_STATE_READY) return HAL_BUSY;
+    i2c_time(Size);
+    return i2c_model_read(DevAddress, pData, Size, now_ns) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    UNUSED(Timeout); UNUSED(MemAddSize);
+    if (hi2c != &hi2c3) return HAL_ERROR;
+    if (hi2c->State != HAL_I2C_STATE_READY) return HAL_BUSY;
+    i2c_time(Size + 1);
+    return i2c_model_mem_write(DevAddress, (uint8_t)MemAddress, pData, Size, now_ns) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    UNUSED(Timeout); UNUSED(MemAddSize);
+    if (hi2c != &hi2c3) return HAL_ERROR;
+    if (hi2c->State != HAL_I2C_STATE_READY) return HAL_BUSY;
+    i2c_time(Size + 2);  // Register address write, repeated start
+    return i2c_model_mem_read(DevAddress, (uint8_t)MemAddress, pData, Size, now_ns) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size) {
+    UNUSED(MemAddSize);
+    if (hi2c != &hi2c3) return HAL_ERROR;
+    if (hi2c->State != HAL_I2C_STATE_READY) return HAL_BUSY;
+    hi2c->State = HAL_I2C_STATE_BUSY_RX;
+    i2c3_xfer.address = DevAddress;
+    i2c3_xfer.reg = (uint8_t)MemAddress;
+    i2c3_xfer.data = pData;
+    i2c3_xfer.size = Size;
+    i2c3_due_ns = now_ns + bytes_ns(Size + 3, 9, I2C3_CLOCK_HZ);
+    i2c3_pending = true;
+    return HAL_OK;
+}
+
+HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef *hi2c) {
+    return hi2c->State;
+}
+
+/* ========================== */
+/*            UART            */
+/* ========================== */
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    UNUSED(pData); UNUSED(Timeout);
+    if (huart != &huart3) return HAL_ERROR;
+    advance_ns(bytes_ns(Size, 10, USART3_BAUD));
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size) {
+    uart_tx_t *tx = NULL;
+    for (size_t i = 0; i < UART_TX_COUNT; i++) {
+        if (uart_tx[i].huart == huart) tx = &uart_tx[i];
+    }
+    if (!tx || Size == 0) return HAL_ERROR;
+    if (tx->pending) return HAL_BUSY;
+    huart->hdmatx = &tx->hdma;
+    tx->data = pData;
+    tx->size = Size;
+    tx->pending = true;
+    tx->due_ns = now_ns + bytes_ns(Size, 10, tx->baud);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size) {
+    if (huart != &huart3 || Size == 0) return HAL_ERROR;
+    if (uart3_rx_buf) return HAL_BUSY;
+    huart->hdmarx = &hdma_usart3_rx;
+    uart3_rx_buf = pData;
+    uart3_rx_size = Size;
+    uart3_rx_count = 0;
+    return HAL_OK;
+}
+
+/* ========================== */
+/*             ADC            */
+/* ========================== */
+
+// Result width: 12 bits, plus log2(ratio) from the oversampler, minus the right shift
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc) {
+    uint32_t bits = 12;
+
+    if (hadc != &hadc1) return HAL_ERROR;
+    if (adc1_buf) return HAL_BUSY;
+    if (hadc->Init.OversamplingMode == ENABLE) {
+        bits += ((hadc->Init.Oversampling.Ratio >> 2) & 0x7) + 1;
+        bits -= (hadc->Init.Oversampling.RightBitShift >> 5) & 0xF;
+    }
+    if (bits > 16) return HAL_ERROR;    // Would not fit the 16-bit data register
+    adc1_full_scale = (1UL << bits) - 1;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig) {
+    if (hadc != &hadc1 || sConfig->Channel != ADC_CHANNEL_3) return HAL_ERROR;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc, uint32_t SingleDiff) {
+    UNUSED(SingleDiff);
+    if (hadc != &hadc1) return HAL_ERROR;
+    advance_ns(116 * 1000000000ULL / 20000000ULL);    // 116 ADC clock cycles
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length) {
+    if (hadc != &hadc1 || Length < 2 || (Length & 1)) return HAL_ERROR;
+    if (adc1_buf) return HAL_BUSY;
+    adc1_buf = (uint16_t *)pData;
+    adc1_len = Length;
+    adc1_running = false;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc) {
+    if (hadc != &hadc1) return HAL_ERROR;
+    adc1_buf = NULL;
+    adc1_running = false;
+    return HAL_OK;
+}
@@ -0,0 +1,91 @@
+/*
+ * host.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ *
+ * Host harness: simulated clock, bus models and RAM disk behind the HAL stub.
+ *
+ * Time only moves when the firmware touches the HAL: HAL_GetTick() costs
+ * HOST_TICK_COST_US, a TIM2 read HOST_TIMER_READ_NS, HAL_Delay() and bus
+ * transfers cost their real duration. Pending timer and UART interrupts are
+ * delivered whenever time moves.
+ */
+
+#ifndef HOST_HOST_H_
+#define HOST_HOST_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HOST_TICK_COST_US   1
+#define HOST_TIMER_READ_NS  50  // So a loop that only polls the timebase still sees time pass
+
+/* ========================== */
+/*      SIMULATED CLOCK       */
+/* ========================== */
+
+uint64_t host_time_us(void);
+void host_advance_us(uint64_t us);
+
+// Called on every clock advance (outside interrupt context), e.g. to stop a run
+void host_set_tick_hook(void (*hook)(uint64_t now_us));
+
+// Bytes sent by UART TX DMA (uart = 1 for USART1, 2 for USART2), from the transfer complete interrupt
+void host_set_uart_tx_sink(void (*sink)(int uart, const uint8_t *data, uint16_t len));
+
+/* ========================== */
+/*       FLIGHT PROFILE       */
+/* ========================== */
+
+typedef struct {
+    double ground_s;          // Time on the pad before liftoff
+    double ascent_rate;       // m/s
+    double apogee_m;          // Altitude above the pad
+    double descent_rate;      // m/s
+    double pad_pressure;      // Pa
+} host_flight_t;
+
+void host_flight_set(const host_flight_t *flight);
+double host_flight_altitude(double t_s);
+double host_flight_duration_s(void);
+
+/* ========================== */
+/*       SENSOR MODELS        */
+/* ========================== */
+
+typedef struct {
+    uint32_t ms5607_conversions;
+    uint32_t ms5607_early_reads;   // ADC read before the conversion time elapsed (returns 0)
+    uint32_t i2c_transfers;
+    uint32_t sds011_frames;
+    uint32_t sds011_corrupted;     // Frames sent with a bad checksum
+    uint32_t sds011_stray_bytes;   // Garbage bytes sent between frames
+} host_sensor_stats_t;
+
+void host_sensor_get_stats(host_sensor_stats_t *stats);
+
+/* ========================== */
+/*          RAM DISK          */
+/* ========================== */
+
+typedef struct {
+    uint64_t sectors_read;
+    uint64_t sectors_written;
+    uint64_t write_calls;
+    uint64_t read_calls;
+    uint64_t busy_us;         // Simulated time spent in the SD driver
+    uint64_t write_errors;    // Write commands failed by host_disk_fail_writes()
+} host_disk_stats_t;
+
+int host_disk_create(uint32_t sectors);
+
+/**
+ * Fail every n-th write command with RES_ERROR, without touching the disk
+ * (0: never). Exercises the black box's recovery from write failures.
+ */
+void host_disk_fail_writes(uint32_t n);
+int host_disk_save(const char *path);
+void host_disk_get_stats(host_disk_stats_t *stats);
+
+#endif /* HOST_HOST_H_ */
@@ -0,0 +1,19 @@
+/*
+ * host_it.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ *
+ * Interrupt handlers of stm32l4xx_it.c that the host emulation raises.
+ */
+
+#include "drivers_h/ms5607.h"
+#include "tools_h/timebase.h"
+
+void TIM2_IRQHandler(void) {
+    timebase_IRQHandler();
+}
+
+void TIM6_DAC_IRQHandler(void) {
+    MS5607_TimerIRQHandler();
+}
@@ -0,0 +1,129 @@
+/*
+ * ram_disk.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ *
+ * RAM-backed replacement for user_diskio_spi.c. Every call costs the
+ * simulated time of the SPI transfer at SD_SPI_MAX_CLOCK_HZ plus a fixed
+ * command overhead and, for writes, the card's programming busy time.
+ */
+
+#include "user_diskio_spi.h"
+#include "tools_h/configuration.h"
+#include "host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SECTOR_SIZE        512
+#define CMD_OVERHEAD_NS    20000ULL    // Command, response and data token
+#define WRITE_BUSY_NS      250000ULL   // Card programming time per write command
+
+static uint8_t *disk;
+static uint32_t disk_sectors;
+static DSTATUS stat = STA_NOINIT;
+static host_disk_stats_t stats;
+static uint32_t fail_every;
+static uint32_t writes_until_fail;
+
+int host_disk_create(uint32_t sectors) {
+    free(disk);
+    disk = calloc(sectors, SECTOR_SIZE);
+    disk_sectors = disk ? sectors : 0;
+    memset(&stats, 0, sizeof(stats));
+    return disk ? 0 : -1;
+}
+
+int host_disk_save(const char *path) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return -1;
+    size_t n = fwrite(disk, SECTOR_SIZE, disk_sectors, f);
+    fclose(f);
+    return n == disk_sectors ? 0 : -1;
+}
+
+void host_disk_fail_writes(uint32_t n) {
+    fail_every = n;
+    writes_until_fail = n;
+}
+
+void host_disk_get_stats(host_disk_stats_t *out) {
+    *out = stats;
+}
+
+static void busy(uint64_t ns) {
+    stats.busy_us += ns / 1000;
+    host_advance_us(ns / 1000);
+}
+
+static uint64_t transfer_ns(UINT count) {
+    return (uint64_t)count * SECTOR_SIZE * 8 * 1000000000ULL / SD_SPI_MAX_CLOCK_HZ;
+}
+
+DSTATUS USER_SPI_initialize(BYTE drv) {
+    if (drv || !disk) return STA_NOINIT;
+    stat = 0;
+    return stat;
+}
+
+DSTATUS USER_SPI_status(BYTE drv) {
+    return drv ? STA_NOINIT : stat;
+}
+
+DRESULT USER_SPI_read(BYTE drv, BYTE *buff, DWORD sector, UINT count) {
+    if (drv || !count) return RES_PARERR;
+    if (stat & STA_NOINIT) return RES_NOTRDY;
+    if (sector + count > disk_sectors) return RES_ERROR;
+
+    memcpy(buff, disk + (size_t)sector * SECTOR_SIZE, (size_t)count * SECTOR_SIZE);
+    stats.read_calls++;
+    stats.sectors_read += count;
+    busy(CMD_OVERHEAD_NS + transfer_ns(count));
+    return RES_OK;
+}
+
+DRESULT USER_SPI_write(BYTE drv, const BYTE *buff, DWORD sector, UINT count) {
+    if (drv || !count) return RES_PARERR;
+    if (stat & STA_NOINIT) return RES_NOTRDY;
+    if (sector + count > disk_sectors) return RES_ERROR;
+    if (fail_every && --writes_until_fail == 0) {
+        writes_until_fail = fail_every;
+        stats.write_errors++;
+        busy(CMD_OVERHEAD_NS + transfer_ns(count));
+        return RES_ERROR;
+    }
+
+    memcpy(disk + (size_t)sector * SECTOR_SIZE, buff, (size_t)count * SECTOR_SIZE);
+    stats.write_calls++;
+    stats.sectors_written += count;
+    busy(CMD_OVERHEAD_NS + transfer_ns(count) + WRITE_BUSY_NS);
+    return RES_OK;
+}
+
+DRESULT USER_SPI_ioctl(BYTE drv, BYTE cmd, void *buff) {
+    DWORD *dp = buff;
+
+    if (drv) return RES_PARERR;
+    if (stat & STA_NOINIT) return RES_NOTRDY;
+
+    switch (cmd) {
+    case CTRL_SYNC:
+        return RES_OK;
+    case GET_SECTOR_COUNT:
+        *dp = disk_sectors;
+        return RES_OK;
+    case GET_BLOCK_SIZE:
+        *dp = 128;          // Erase block in sectors (64 KiB allocation units)
+        return RES_OK;
+    case CTRL_TRIM:
+    case CTRL_STREAM_PREERASE:
+        return RES_OK;
+    default:
+        return RES_PARERR;
+    }
+}
+
+DWORD USER_SPI_clock_hz(void) {
+    return SD_SPI_MAX_CLOCK_HZ;
+}
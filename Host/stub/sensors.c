@@ -0,0 +1,396 @@
+/*
+ * sensors.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#include "sensors.h"
+#include "host.h"
+#include <math.h>
+#include <string.h>
+
+#define NS_PER_S      1000000000ULL
+#define AHT21_ADDR    (0x38 << 1)
+#define ENS160_ADDR   (0x53 << 1)
+
+static host_flight_t flight = {
+    .ground_s = 10.0,
+    .ascent_rate = 20.0,
+    .apogee_m = 2000.0,
+    .descent_rate = 10.0,
+    .pad_pressure = 101325.0,
+};
+
+static host_sensor_stats_t stats;
+
+/* ========================== */
+/*       FLIGHT PROFILE       */
+/* ========================== */
+
+void host_flight_set(const host_flight_t *f) {
+    flight = *f;
+}
+
+double host_flight_duration_s(void) {
+    return flight.ground_s + flight.apogee_m / flight.ascent_rate + flight.apogee_m / flight.descent_rate;
+}
+
+double host_flight_altitude(double t) {
+    double ascent_s = flight.apogee_m / flight.ascent_rate;
+    t -= flight.ground_s;
+    if (t <= 0.0) return 0.0;
+    if (t <= ascent_s) return t * flight.ascent_rate;
+    double alt = flight.apogee_m - (t - ascent_s) * flight.descent_rate;
+    return alt > 0.0 ? alt : 0.0;
+}
+
+// U.S. Standard Atmosphere 1976 troposphere/lower stratosphere, scaled to the pad pressure
+static double pressure_at(double alt) {
+    const double g_r = 9.80665 * 0.0289644 / 8.3144598;
+    double p;
+    if (alt < 11000.0) {
+        p = 101325.0 * pow(1.0 - 0.0065 * alt / 288.15, g_r / 0.0065);
+    } else {
+        p = 22632.10 * exp(-g_r * (alt - 11000.0) / 216.65);
+    }
+    return p * flight.pad_pressure / 101325.0;
+}
+
+static double seconds(uint64_t now_ns) {
+    return (double)now_ns / NS_PER_S;
+}
+
+static double altitude_at(uint64_t now_ns) {
+    return host_flight_altitude(seconds(now_ns));
+}
+
+void host_sensor_get_stats(host_sensor_stats_t *out) {
+    *out = stats;
+}
+
+/* ========================== */
+/*        MS5607 (SPI1)       */
+/* ========================== */
+
+// Datasheet example calibration; word 0 is factory data and must not read as 0x0000/0xFFFF
+static const uint16_t ms5607_prom[8] = { 0x0042, 46372, 43981, 29059, 27842, 31553, 28165, 0x000B };
+
+// Maximum conversion time per OSR, so a driver waiting less gets caught
+static const uint32_t ms5607_conv_us[5] = { 600, 1170, 2280, 4540, 9040 };
+
+static struct {
+    bool     selected;
+    bool     command_pending;  // Next byte in this chip select window is a command
+    uint8_t  out[3];
+    uint8_t  out_len, out_pos;
+    bool     converting;
+    uint64_t conv_done_ns;
+    uint32_t result;
+} ms;
+
+static void ms5607_compensate(uint32_t d1, uint32_t d2, int32_t *temp, int32_t *pressure) {
+    int64_t dT = (int64_t)d2 - ((int64_t)ms5607_prom[5] << 8);
+    int64_t t = 2000 + ((dT * ms5607_prom[6]) >> 23);
+    int64_t off = ((int64_t)ms5607_prom[2] << 17) + ((ms5607_prom[4] * dT) >> 6);
+    int64_t sens = ((int64_t)ms5607_prom[1] << 16) + ((ms5607_prom[3] * dT) >> 7);
+
+    if (t < 2000) {
+        int64_t t2 = (dT * dT) >> 31;
+        int64_t off2 = (61 * (t - 2000) * (t - 2000)) >> 4;
+        int64_t sens2 = 2 * (t - 2000) * (t - 2000);
+        if (t < -1500) {
+            off2 += 15 * (t + 1500) * (t + 1500);
+            sens2 += 8 * (t + 1500) * (t + 1500);
+        }
+        t -= t2;
+        off -= off2;
+        sens -= sens2;
+    }
+    *temp = (int32_t)t;
+    *pressure = (int32_t)((((int64_t)d1 * sens >> 21) - off) >> 15);
+}
+
+// Both outputs are monotonic in their ADC value: invert them by bisection
+static uint32_t ms5607_raw_d2(int32_t temp_centi) {
+    uint32_t lo = 0, hi = 0xFFFFFF;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        int32_t t, p;
+        ms5607_compensate(0x800000, mid, &t, &p);
+        if (t < temp_centi) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+static uint32_t ms5607_raw_d1(int32_t pressure_pa, uint32_t d2) {
+    uint32_t lo = 0, hi = 0xFFFFFF;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        int32_t t, p;
+        ms5607_compensate(mid, d2, &t, &p);
+        if (p < pressure_pa) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+static int32_t ms5607_temperature_centi(double alt) {
+    double t = 25.0 - 0.0025 * alt;   // Inside the gondola: cools slower than the air
+    return (int32_t)lround((t < -30.0 ? -30.0 : t) * 100.0);
+}
+
+static void ms5607_command(uint8_t cmd, uint64_t now_ns) {
+    ms.out_len = ms.out_pos = 0;
+
+    if (cmd == 0x00) {                          // ADC read
+        uint32_t value = 0;
+        if (ms.converting && now_ns >= ms.conv_done_ns) {
+            value = ms.result;
+        } else {
+            stats.ms5607_early_reads++;
+        }
+        ms.converting = false;
+        ms.out[0] = (uint8_t)(value >> 16);
+        ms.out[1] = (uint8_t)(value >> 8);
+        ms.out[2] = (uint8_t)value;
+        ms.out_len = 3;
+    } else if ((cmd & 0xF0) == 0xA0) {          // PROM read
+        uint16_t word = ms5607_prom[(cmd >> 1) & 0x07];
+        ms.out[0] = (uint8_t)(word >> 8);
+        ms.out[1] = (uint8_t)word;
+        ms.out_len = 2;
+    } else if ((cmd & 0xE0) == 0x40) {          // D1 (0x4x) or D2 (0x5x) conversion
+        double alt = altitude_at(now_ns);
+        int32_t temp = ms5607_temperature_centi(alt);
+        uint32_t d2 = ms5607_raw_d2(temp);
+        ms.result = (cmd & 0x10) ? d2 : ms5607_raw_d1((int32_t)lround(pressure_at(alt)), d2);
+        ms.converting = true;
+        ms.conv_done_ns = now_ns + (uint64_t)ms5607_conv_us[((cmd & 0x0F) >> 1) % 5] * 1000;
+        stats.ms5607_conversions++;
+    } else if (cmd == 0x1E) {                   // Reset
+        ms.converting = false;
+    }
+}
+
+void ms5607_model_select(bool selected, uint64_t now_ns) {
+    (void)now_ns;
+    if (selected && !ms.selected) {
+        ms.command_pending = true;
+    }
+    ms.selected = selected;
+}
+
+void ms5607_model_transfer(const uint8_t *tx, uint8_t *rx, uint16_t size, uint64_t now_ns) {
+    for (uint16_t i = 0; i < size; i++) {
+        if (tx && ms.selected && ms.command_pending) {
+            ms.command_pending = false;
+            ms5607_command(tx[i], now_ns);
+            continue;
+        }
+        if (rx) {
+            rx[i] = (ms.selected && ms.out_pos < ms.out_len) ? ms.out[ms.out_pos++] : 0x00;
+        }
+    }
+}
+
+/* ========================== */
+/*      AHT21 / ENS160 (I2C3) */
+/* ========================== */
+
+static uint8_t aht21_crc8(const uint8_t *data, int len) {
+    uint8_t crc = 0xFF;
+    while (len--) {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++) crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+static struct {
+    bool     status_requested;
+    uint64_t measure_ns;
+} aht;
+
+static struct {
+    uint8_t  regs[256];
+    uint64_t last_update_s;
+} ens;
+
+bool i2c_model_present(uint16_t address) {
+    return address == AHT21_ADDR || address == ENS160_ADDR;
+}
+
+bool i2c_model_write(uint16_t address, const uint8_t *data, uint16_t size, uint64_t now_ns) {
+    stats.i2c_transfers++;
+    if (address != AHT21_ADDR || size == 0) return address == ENS160_ADDR;
+
+    if (data[0] == 0x71) {
+        aht.status_requested = true;
+    } else if (data[0] == 0xAC) {
+        aht.status_requested = false;
+        aht.measure_ns = now_ns;
+    }
+    return true;
+}
+
+bool i2c_model_read(uint16_t address, uint8_t *data, uint16_t size, uint64_t now_ns) {
+    stats.i2c_transfers++;
+    if (address != AHT21_ADDR) return false;
+
+    double alt = altitude_at(now_ns);
+    double temp = 15.0 - 0.0065 * alt;
+    double rh = 60.0 - 0.004 * alt;
+    if (temp < -56.5) temp = -56.5;
+    if (rh < 5.0) rh = 5.0;
+
+    uint32_t h = (uint32_t)(rh / 100.0 * 1048576.0);
+    uint32_t t = (uint32_t)((temp + 50.0) / 200.0 * 1048576.0);
+    bool busy = (now_ns - aht.measure_ns) < 80ULL * 1000000ULL;
+    uint8_t frame[7] = {
+        (uint8_t)(0x18 | (busy && !aht.status_requested ? 0x80 : 0x00)),
+        (uint8_t)(h >> 12), (uint8_t)(h >> 4),
+        (uint8_t)(((h & 0x0F) << 4) | ((t >> 16) & 0x0F)),
+        (uint8_t)(t >> 8), (uint8_t)t,
+    };
+    frame[6] = aht21_crc8(frame, 6);
+    memcpy(data, frame, size < sizeof(frame) ? size : sizeof(frame));
+    return true;
+}
+
+static void ens160_update(uint64_t now_ns) {
+    uint64_t s = now_ns / NS_PER_S;
+    if (ens.regs[0x10] != 0x02 || s == ens.last_update_s) return;   // New data once a second in standard mode
+    ens.last_update_s = s;
+
+    double t = seconds(now_ns);
+    uint16_t eco2 = (uint16_t)(450.0 + 50.0 * sin(t / 30.0));
+    uint16_t tvoc = (uint16_t)(60.0 + 20.0 * sin(t / 45.0));
+    ens.regs[0x21] = (uint8_t)(1 + (s / 60) % 3);
+    ens.regs[0x22] = (uint8_t)tvoc;
+    ens.regs[0x23] = (uint8_t)(tvoc >> 8);
+    ens.regs[0x24] = (uint8_t)eco2;
+    ens.regs[0x25] = (uint8_t)(eco2 >> 8);
+    ens.regs[0x20] = 0x80 | 0x02;   // STATAS | NEWDAT
+}
+
+bool i2c_model_mem_write(uint16_t address, uint8_t reg, const uint8_t *data, uint16_t size, uint64_t now_ns) {
+    (void)now_ns;
+    stats.i2c_transfers++;
+    if (address != ENS160_ADDR) return false;
+    for (uint16_t i = 0; i < size; i++) {
+        ens.regs[(uint8_t)(reg + i)] = data[i];
+    }
+    return true;
+}
+
+bool i2c_model_mem_read(uint16_t address, uint8_t reg, uint8_t *data, uint16_t size, uint64_t now_ns) {
+    stats.i2c_transfers++;
+    if (address != ENS160_ADDR) return false;
+
+    ens.regs[0x00] = 0x60;          // PART_ID 0x0160
+    ens.regs[0x01] = 0x01;
+    ens160_update(now_ns);
+    for (uint16_t i = 0; i < size; i++) {
+        uint8_t r = (uint8_t)(reg + i);
+        data[i] = ens.regs[r];
+        if (r >= 0x21 && r <= 0x25) ens.regs[0x20] &= (uint8_t)~0x02;
+    }
+    return true;
+}
+
+/* ========================== */
+/*       SDS011 (USART3)      */
+/* ========================== */
+
+#define SDS011_BYTE_NS  (10ULL * NS_PER_S / 9600)
+
+// Line faults the driver has to survive: a stray byte ahead of some frames, a bad checksum in others
+#define SDS011_STRAY_EVERY     29
+#define SDS011_CORRUPT_EVERY   31
+
+static struct {
+    uint64_t frame;         // Frame n starts at n seconds
+    uint8_t  pos;
+    uint8_t  len;
+    uint8_t  bytes[11];
+} sds;
+
+static void sds011_build_frame(uint64_t frame) {
+    double t = (double)frame;
+    uint16_t pm25 = (uint16_t)(123.0 + 40.0 * sin(t / 20.0));   // 0.1 ug/m3
+    uint16_t pm10 = (uint16_t)(201.0 + 60.0 * sin(t / 25.0));
+    uint8_t *b = sds.bytes;
+
+    sds.len = 10;
+    if (frame % SDS011_STRAY_EVERY == 5) {
+        *b++ = 0xAA;        // Looks like a header, must not derail the parser
+        sds.len++;
+        stats.sds011_stray_bytes++;
+    }
+    b[0] = 0xAA;
+    b[1] = 0xC0;
+    b[2] = (uint8_t)pm25;
+    b[3] = (uint8_t)(pm25 >> 8);
+    b[4] = (uint8_t)pm10;
+    b[5] = (uint8_t)(pm10 >> 8);
+    b[6] = 0x12;
+    b[7] = 0x34;
+    uint8_t sum = 0;
+    for (int i = 2; i < 8; i++) sum += b[i];
+    b[8] = sum;
+    b[9] = 0xAB;
+    if (frame % SDS011_CORRUPT_EVERY == 9) {
+        b[8]++;
+        stats.sds011_corrupted++;
+    }
+    stats.sds011_frames++;
+}
+
+uint64_t sds011_model_next_ns(void) {
+    return sds.frame * NS_PER_S + (sds.pos + 1) * SDS011_BYTE_NS;
+}
+
+bool sds011_model_rx(uint64_t until_ns, uint64_t *at_ns, uint8_t *byte) {
+    uint64_t when = sds011_model_next_ns();
+    if (when > until_ns) return false;
+
+    if (sds.pos == 0) sds011_build_frame(sds.frame);
+    *at_ns = when;
+    *byte = sds.bytes[sds.pos++];
+    if (sds.pos == sds.len) {
+        sds.pos = 0;
+        sds.frame++;
+    }
+    return true;
+}
+
+/* ========================== */
+/*      MICS-5524 (ADC1)      */
+/* ========================== */
+
+#define MICS5524_VREF          5.0
+#define MICS5524_CLEAN_AIR_V   1.20    // Divider output in clean air
+#define MICS5524_PLUME_V       0.30    // Extra output at the centre of the gas layer
+#define MICS5524_PLUME_ALT_M   800.0
+#define MICS5524_PLUME_WIDTH_M 150.0
+#define MICS5524_NOISE_V       0.004   // Peak-to-peak, per oversampled result
+
+static uint32_t mics5524_noise_state = 0x2545F491u;
+
+static double mics5524_noise(void) {
+    // xorshift32, uniform in [-0.5, 0.5)
+    mics5524_noise_state ^= mics5524_noise_state << 13;
+    mics5524_noise_state ^= mics5524_noise_state >> 17;
+    mics5524_noise_state ^= mics5524_noise_state << 5;
+    return (double)mics5524_noise_state / 4294967296.0 - 0.5;
+}
+
+uint16_t mics5524_model_sample(uint64_t now_ns, uint32_t full_scale) {
+    double d = (altitude_at(now_ns) - MICS5524_PLUME_ALT_M) / MICS5524_PLUME_WIDTH_M;
+    double v = MICS5524_CLEAN_AIR_V + MICS5524_PLUME_V * exp(-d * d) + MICS5524_NOISE_V * mics5524_noise();
+    double code = v / MICS5524_VREF * full_scale + 0.5;
+
+    if (code < 0.0) code = 0.0;
+    if (code > full_scale) code = full_scale;
+    return (uint16_t)code;
+}
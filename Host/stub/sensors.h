@@ -0,0 +1,35 @@
+/*
+ * sensors.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ *
+ * Bus-level models of the flight sensors, fed by the synthetic flight
+ * profile. Only hal_stub.c talks to them.
+ */
+
+#ifndef HOST_SENSORS_H_
+#define HOST_SENSORS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// MS5607 on SPI1 (chip select PA4)
+void ms5607_model_select(bool selected, uint64_t now_ns);
+void ms5607_model_transfer(const uint8_t *tx, uint8_t *rx, uint16_t size, uint64_t now_ns);
+
+// AHT21 and ENS160 on I2C3 (8-bit HAL addresses)
+bool i2c_model_present(uint16_t address);
+bool i2c_model_write(uint16_t address, const uint8_t *data, uint16_t size, uint64_t now_ns);
+bool i2c_model_read(uint16_t address, uint8_t *data, uint16_t size, uint64_t now_ns);
+bool i2c_model_mem_write(uint16_t address, uint8_t reg, const uint8_t *data, uint16_t size, uint64_t now_ns);
+bool i2c_model_mem_read(uint16_t address, uint8_t reg, uint8_t *data, uint16_t size, uint64_t now_ns);
+
+// SDS011 on USART3: next byte on the line no later than until_ns
+bool sds011_model_rx(uint64_t until_ns, uint64_t *at_ns, uint8_t *byte);
+uint64_t sds011_model_next_ns(void);    // Arrival time of the next byte
+
+// MICS-5524 on ADC1 channel 3: oversampled conversion result (full_scale = max code)
+uint16_t mics5524_model_sample(uint64_t now_ns, uint32_t full_scale);
+
+#endif /* HOST_SENSORS_H_ */
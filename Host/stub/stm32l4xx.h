@@ -0,0 +1,13 @@
+/*
+ * stm32l4xx.h (host stub)
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ */
+
+#ifndef HOST_STM32L4XX_H_
+#define HOST_STM32L4XX_H_
+
+#include "stm32l4xx_hal.h"
+
+#endif /* HOST_STM32L4XX_H_ */
@@ -0,0 +1,284 @@
+/*
+ * stm32l4xx_hal.h (host stub)
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ *
+ * Just enough of the STM32L4 HAL and CMSIS register map for the application
+ * code to build on a PC. Bus transfers are routed to the sensor models in
+ * sensors.c, timers and interrupts are emulated in hal_stub.c against a
+ * simulated microsecond clock (see host.h).
+ */
+
+#ifndef HOST_STM32L4XX_HAL_H_
+#define HOST_STM32L4XX_HAL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define __weak   __attribute__((weak))
+#define __IO     volatile
+#define UNUSED(X) (void)(X)
+
+/* ========================== */
+/*        HAL TYPES           */
+/* ========================== */
+
+typedef enum {
+    HAL_OK      = 0x00,
+    HAL_ERROR   = 0x01,
+    HAL_BUSY    = 0x02,
+    HAL_TIMEOUT = 0x03
+} HAL_StatusTypeDef;
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct {
+    __IO uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef enum {
+    HAL_SPI_STATE_RESET = 0,
+    HAL_SPI_STATE_READY,
+    HAL_SPI_STATE_BUSY
+} HAL_SPI_StateTypeDef;
+
+typedef struct {
+    void *Instance;
+} DMA_HandleTypeDef;
+
+typedef struct {
+    void *Instance;
+    HAL_SPI_StateTypeDef State;
+} SPI_HandleTypeDef;
+
+typedef enum {
+    HAL_I2C_STATE_RESET = 0,
+    HAL_I2C_STATE_READY,
+    HAL_I2C_STATE_BUSY_RX
+} HAL_I2C_StateTypeDef;
+
+typedef struct {
+    void *Instance;
+    __IO HAL_I2C_StateTypeDef State;
+} I2C_HandleTypeDef;
+
+typedef struct {
+    void *Instance;
+    DMA_HandleTypeDef *hdmarx;
+    DMA_HandleTypeDef *hdmatx;
+} UART_HandleTypeDef;
+
+#define DMA_IT_HT                   (1U << 2)
+#define __HAL_DMA_DISABLE_IT(h, it) ((void)(h), (void)(it))
+#define __DMB()                     __sync_synchronize()
+
+typedef enum {
+    DISABLE = 0,
+    ENABLE = !DISABLE
+} FunctionalState;
+
+typedef struct {
+    uint32_t Ratio;
+    uint32_t RightBitShift;
+    uint32_t TriggeredMode;
+    uint32_t OversamplingStopReset;
+} ADC_OversamplingTypeDef;
+
+typedef struct {
+    uint32_t ExternalTrigConv;
+    uint32_t ExternalTrigConvEdge;
+    FunctionalState ContinuousConvMode;
+    FunctionalState DMAContinuousRequests;
+    uint32_t Overrun;
+    FunctionalState OversamplingMode;
+    ADC_OversamplingTypeDef Oversampling;
+} ADC_InitTypeDef;
+
+typedef struct {
+    void *Instance;
+    ADC_InitTypeDef Init;
+} ADC_HandleTypeDef;
+
+typedef struct {
+    uint32_t Channel;
+    uint32_t Rank;
+    uint32_t SamplingTime;
+    uint32_t SingleDiff;
+    uint32_t OffsetNumber;
+    uint32_t Offset;
+} ADC_ChannelConfTypeDef;
+
+#define ADC_EXTERNALTRIG_T15_TRGO           (1U << 0)
+#define ADC_EXTERNALTRIGCONVEDGE_RISING     (1U << 10)
+#define ADC_OVR_DATA_OVERWRITTEN            (1U << 12)
+#define ADC_OVERSAMPLING_RATIO_16           (3U << 2)
+#define ADC_RIGHTBITSHIFT_2                 (2U << 5)
+#define ADC_TRIGGEREDMODE_SINGLE_TRIGGER    0U
+#define ADC_REGOVERSAMPLING_CONTINUED_MODE  0U
+#define ADC_CHANNEL_3                       3U
+#define ADC_REGULAR_RANK_1                  1U
+#define ADC_SAMPLETIME_92CYCLES_5           5U
+#define ADC_SINGLE_ENDED                    0U
+#define ADC_OFFSET_NONE                     4U
+
+#define GPIO_PIN_0   ((uint16_t)0x0001)
+#define GPIO_PIN_1   ((uint16_t)0x0002)
+#define GPIO_PIN_2   ((uint16_t)0x0004)
+#define GPIO_PIN_3   ((uint16_t)0x0008)
+#define GPIO_PIN_4   ((uint16_t)0x0010)
+#define GPIO_PIN_5   ((uint16_t)0x0020)
+#define GPIO_PIN_6   ((uint16_t)0x0040)
+#define GPIO_PIN_7   ((uint16_t)0x0080)
+#define GPIO_PIN_8   ((uint16_t)0x0100)
+#define GPIO_PIN_9   ((uint16_t)0x0200)
+#define GPIO_PIN_10  ((uint16_t)0x0400)
+#define GPIO_PIN_11  ((uint16_t)0x0800)
+#define GPIO_PIN_12  ((uint16_t)0x1000)
+#define GPIO_PIN_13  ((uint16_t)0x2000)
+#define GPIO_PIN_14  ((uint16_t)0x4000)
+#define GPIO_PIN_15  ((uint16_t)0x8000)
+
+#define I2C_MEMADD_SIZE_8BIT   0x00000001U
+#define I2C_MEMADD_SIZE_16BIT  0x00000002U
+
+/* ========================== */
+/*     CMSIS REGISTER MAP     */
+/* ========================== */
+
+typedef enum {
+    TIM2_IRQn = 28,
+    TIM6_DAC_IRQn = 54
+} IRQn_Type;
+
+typedef struct {
+    __IO uint32_t CR1, CR2, SMCR, DIER, SR, EGR, CCMR1, CCMR2, CCER, CNT, PSC, ARR;
+} TIM_TypeDef;
+
+typedef struct {
+    __IO uint32_t CR, CFGR, APB1ENR1, APB1ENR2, APB2ENR, BDCR;
+} RCC_TypeDef;
+
+typedef struct {
+    __IO uint32_t CR1;
+} PWR_TypeDef;
+
+typedef struct {
+    __IO uint32_t CTRL, CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    __IO uint32_t DHCSR, DCRSR, DCRDR, DEMCR;
+} CoreDebug_Type;
+
+typedef struct {
+    union {
+        __IO uint8_t  u8;
+        __IO uint16_t u16;
+        __IO uint32_t u32;
+    } PORT[32];
+    __IO uint32_t TER, TCR;
+} ITM_Type;
+
+extern uint32_t SystemCoreClock;
+
+// The cycle counter follows the simulated clock at SystemCoreClock
+DWT_Type *host_dwt(void);
+
+// TIM2 counts the simulated clock once enabled (CNT is refreshed on access)
+TIM_TypeDef *host_tim2(void);
+
+extern GPIO_TypeDef host_gpio[3];
+extern TIM_TypeDef  host_tim6;
+extern TIM_TypeDef  host_tim15;
+extern RCC_TypeDef  host_rcc;
+extern PWR_TypeDef  host_pwr;
+extern CoreDebug_Type host_core_debug;
+extern ITM_Type     host_itm;       // Left disabled: no debugger attached
+
+#define GPIOA   (&host_gpio[0])
+#define GPIOB   (&host_gpio[1])
+#define GPIOC   (&host_gpio[2])
+#define TIM2    (host_tim2())
+#define TIM6    (&host_tim6)
+#define TIM15   (&host_tim15)
+#define RCC     (&host_rcc)
+#define PWR     (&host_pwr)
+#define DWT     (host_dwt())
+#define CoreDebug (&host_core_debug)
+#define ITM     (&host_itm)
+
+#define DWT_CTRL_CYCCNTENA_Msk        (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk    (1UL << 24)
+#define ITM_TCR_ITMENA_Msk            (1UL << 0)
+#define __NOP()                       ((void)0)
+
+#define RCC_CFGR_PPRE1          (0x7U << 8)
+#define RCC_CFGR_PPRE1_DIV1     (0x0U << 8)
+#define RCC_CFGR_PPRE2          (0x7U << 11)
+#define RCC_CFGR_PPRE2_DIV1     (0x0U << 11)
+#define RCC_APB2ENR_TIM15EN     (1U << 16)
+#define RCC_APB1ENR1_TIM2EN     (1U << 0)
+#define RCC_APB1ENR1_TIM6EN     (1U << 4)
+#define RCC_APB1ENR1_PWREN      (1U << 28)
+#define RCC_CR_MSIPLLEN         (1U << 2)
+#define RCC_BDCR_LSEON          (1U << 0)
+#define RCC_BDCR_LSERDY         (1U << 1)
+#define PWR_CR1_DBP             (1U << 8)
+
+#define TIM_CR1_CEN             (1U << 0)
+#define TIM_CR1_URS             (1U << 2)
+#define TIM_CR1_OPM             (1U << 3)
+#define TIM_CR2_MMS_1           (1U << 5)
+#define TIM_DIER_UIE            (1U << 0)
+#define TIM_SR_UIF              (1U << 0)
+#define TIM_EGR_UG              (1U << 0)
+
+/* ========================== */
+/*      HAL FUNCTIONS         */
+/* ========================== */
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig);
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc, uint32_t SingleDiff);
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length);
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+
+#endif /* HOST_STM32L4XX_HAL_H_ */
@@ -0,0 +1,60 @@
+/*
+ * altitude_accuracy.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ *
+ * Compares altitude_from_pressure() with the double-precision pow() formula
+ * it replaces, over the standard atmosphere pressures from 0 to 40 km and a
+ * spread of ground reference pressures.
+ */
+
+#include "tools_h/altitude.h"
+#include <math.h>
+#include <stdio.h>
+
+#define MAX_ERROR_M   0.05
+#define STEP_M        1.0
+#define TOP_M         40000.0
+
+// U.S. Standard Atmosphere 1976 pressure for a geopotential altitude (0 - 47 km)
+static double standard_pressure(double h) {
+    const double g_r = 9.80665 * 0.0289644 / 8.3144598;
+    if (h < 11000.0) {
+        return 101325.0 * pow(288.15 / (288.15 - 0.0065 * h), -g_r / 0.0065);
+    }
+    if (h < 20000.0) {
+        return 22632.10 * exp(-g_r * (h - 11000.0) / 216.65);
+    }
+    if (h < 32000.0) {
+        return 5474.89 * pow(216.65 / (216.65 + 0.001 * (h - 20000.0)), g_r / 0.001);
+    }
+    return 868.02 * pow(228.65 / (228.65 + 0.0028 * (h - 32000.0)), g_r / 0.0028);
+}
+
+static double reference_altitude(double pressure, double reference_pressure) {
+    return 44330.0 * (1.0 - pow(pressure / reference_pressure, 0.1903));
+}
+
+int main(void) {
+    const double ground[] = { 95000.0, 101325.0, 103500.0 };
+    double worst = 0.0, worst_h = 0.0, worst_p0 = 0.0;
+
+    for (unsigned i = 0; i < sizeof(ground) / sizeof(ground[0]); i++) {
+        for (double h = 0.0; h <= TOP_M; h += STEP_M) {
+            double p = standard_pressure(h) * ground[i] / 101325.0;
+            double expected = reference_altitude((float)p, (float)ground[i]);
+            double actual = altitude_from_pressure((float)p, (float)ground[i]);
+            double err = fabs(actual - expected);
+            if (err > worst) {
+                worst = err;
+                worst_h = h;
+                worst_p0 = ground[i];
+            }
+        }
+    }
+
+    printf("altitude_from_pressure: max |error| %.4f m (at %.0f m, p0 %.0f Pa), limit %.2f m\n",
+           worst, worst_h, worst_p0, MAX_ERROR_M);
+    return worst <= MAX_ERROR_M ? 0 : 1;
+}
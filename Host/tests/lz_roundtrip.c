@@ -0,0 +1,129 @@
+/*
+ * lz_roundtrip.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ *
+ * Compresses inputs with the streaming compressor (tools_h/lz_stream.h),
+ * fed in random-sized pieces with flushes in between like the black box
+ * does, and checks that a straightforward decoder of the documented format
+ * gives the input back: repetitive log text, random bytes, long runs, and
+ * enough data for the 16-bit hash positions to wrap several times.
+ */
+
+#include "tools_h/lz_stream.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INPUT_MAX  (300U * 1024U)
+
+static int failures;
+
+#define EXPECT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+static lz_stream_t lz;
+static uint8_t input[INPUT_MAX];
+static uint8_t packed[INPUT_MAX * 2];
+static uint8_t output[INPUT_MAX];
+static uint32_t packed_len;
+
+static void sink(void *ctx, const uint8_t *data, uint32_t len) {
+    (void)ctx;
+    EXPECT(len <= LZ_GROUP_MAX);
+    memcpy(&packed[packed_len], data, len);
+    packed_len += len;
+}
+
+// Returns the decoded length, or -1 on a malformed stream
+static long decode(const uint8_t *in, uint32_t len, uint8_t *out) {
+    uint32_t pos = 0, n = 0;
+
+    while (pos < len) {
+        uint8_t flags = in[pos++];
+        for (int bit = 0; bit < 8; bit++) {
+            if (pos >= len) return -1;          // Every group is complete in these tests
+            if (!(flags & (1u << bit))) {
+                out[n++] = in[pos++];
+                continue;
+            }
+            if (pos + 2 > len) return -1;
+            uint32_t offset = in[pos] | ((in[pos + 1] & 0x07u) << 8);
+            uint32_t length = (in[pos + 1] >> 3) + LZ_MIN_MATCH;
+            pos += 2;
+            if (offset == 0) break;
+            if (offset > n || offset > LZ_MAX_OFFSET) return -1;
+            while (length--) {
+                out[n] = out[n - offset];
+                n++;
+            }
+        }
+    }
+    return (long)n;
+}
+
+static void roundtrip(const char *name, uint32_t len, int flush_often) {
+    packed_len = 0;
+    lz_stream_init(&lz, sink, NULL);
+
+    for (uint32_t pos = 0; pos < len;) {
+        uint32_t piece = 1 + (uint32_t)rand() % 300;
+        if (piece > len - pos) piece = len - pos;
+        lz_stream_write(&lz, &input[pos], piece);
+        pos += piece;
+        if (flush_often && rand() % 4 == 0) {
+            lz_stream_flush(&lz);
+        }
+    }
+    lz_stream_flush(&lz);
+
+    long n = decode(packed, packed_len, output);
+    EXPECT(n == (long)len);
+    EXPECT(n == (long)len && memcmp(input, output, len) == 0);
+    EXPECT(lz.bytes_in == len && lz.bytes_out == packed_len);
+    printf("  %-12s %7u -> %7u bytes (%.1f%%)%s\n", name, len, packed_len,
+           len ? 100.0 * packed_len / len : 0.0, flush_often ? ", frequent flushes" : "");
+}
+
+static uint32_t fill_text(void) {
+    uint32_t len = 0;
+    for (uint32_t i = 0; len < INPUT_MAX - 200; i++) {
+        len += (uint32_t)snprintf((char *)&input[len], 200,
+                                  "00:00:%02u:%03u,BAROMETER,[BAROMETER] Pressure: %u.000 Pa, Temp: %u.%02u degC\r\n",
+                                  (i / 100) % 60, (i * 9) % 1000, 101325 - i % 500, 24 + i % 2, i % 100);
+    }
+    return len;
+}
+
+int main(void) {
+    srand(1);
+
+    roundtrip("empty", 0, 0);
+
+    memcpy(input, "ab", 2);
+    roundtrip("tiny", 2, 0);
+
+    uint32_t len = fill_text();
+    roundtrip("text", len, 0);
+    EXPECT(packed_len < len / 2);
+    roundtrip("text", len, 1);
+
+    for (uint32_t i = 0; i < INPUT_MAX; i++) input[i] = (uint8_t)rand();
+    roundtrip("random", INPUT_MAX, 0);
+    EXPECT(packed_len <= INPUT_MAX + INPUT_MAX / 8 + 3);
+
+    memset(input, 0x55, INPUT_MAX);
+    roundtrip("run", INPUT_MAX, 0);
+
+    // Short alphabet: many hash collisions and matches at every distance
+    for (uint32_t i = 0; i < INPUT_MAX; i++) input[i] = (uint8_t)("abc"[rand() % 3]);
+    roundtrip("abc", INPUT_MAX, 1);
+
+    printf("lz_roundtrip: %s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,302 @@
+/*
+ * ring_stress.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: yaxsomo
+ *
+ * Exercises the SPSC ring (tools_h/ring.h): the edge cases on one thread,
+ * then a producer and a consumer thread hammering a small ring, once with
+ * the producer retrying on full (nothing may be lost) and once dropping
+ * like an interrupt handler would (what arrives must stay in order and
+ * intact, and arrived + dropped must add up). Byte streams get the same:
+ * variable-length messages written whole or dropped whole, read back in
+ * contiguous runs the way the console hands them to a DMA.
+ */
+
+#include "tools_h/ring.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+
+#define STRESS_ITEMS     1000000U
+#define STRESS_CAPACITY  16U
+#define STREAM_MESSAGES  300000U
+#define STREAM_CAPACITY  256U
+#define STREAM_MAX_LEN   40U
+
+// Same size as a queued barometer sample; check guards against torn copies
+typedef struct {
+    uint32_t seq;
+    uint32_t payload[2];
+    uint32_t check;
+} Item;
+
+typedef struct {
+    Ring ring;
+    Item storage[STRESS_CAPACITY];
+    int retry;                  // Producer spins on a full ring instead of dropping
+    uint32_t received;
+    uint32_t out_of_order;
+    uint32_t corrupted;
+} Stress;
+
+static int failures;
+
+#define EXPECT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+static Item make_item(uint32_t seq) {
+    Item item = { seq, { seq * 2654435761U, ~seq }, 0 };
+    item.check = item.seq ^ item.payload[0] ^ item.payload[1] ^ 0xA5A5A5A5U;
+    return item;
+}
+
+static int item_ok(const Item *item) {
+    return item->check == (item->seq ^ item->payload[0] ^ item->payload[1] ^ 0xA5A5A5A5U)
+        && item->payload[0] == item->seq * 2654435761U && item->payload[1] == ~item->seq;
+}
+
+static void test_single_thread(void) {
+    Ring ring;
+    Item storage[4], item;
+
+    EXPECT(!ring_init(&ring, storage, sizeof(Item), 0));
+    EXPECT(!ring_init(&ring, storage, sizeof(Item), 3));
+    EXPECT(ring_init(&ring, storage, sizeof(Item), 4));
+
+    EXPECT(!ring_pop(&ring, &item));
+    for (uint32_t i = 0; i < 4; i++) {
+        item = make_item(i);
+        EXPECT(ring_push(&ring, &item));
+    }
+    item = make_item(4);
+    EXPECT(!ring_push(&ring, &item));
+    EXPECT(ring.dropped == 1);
+    EXPECT(ring_count(&ring) == 4);
+    for (uint32_t i = 0; i < 4; i++) {
+        EXPECT(ring_pop(&ring, &item) && item.seq == i && item_ok(&item));
+    }
+    EXPECT(!ring_pop(&ring, &item));
+
+    // Indices run freely: go across the 2^32 wrap
+    ring.head = ring.tail = 0xFFFFFFFEU;
+    for (uint32_t i = 0; i < 4; i++) {
+        item = make_item(100 + i);
+        EXPECT(ring_push(&ring, &item));
+    }
+    EXPECT(ring_count(&ring) == 4);
+    item = make_item(104);
+    EXPECT(!ring_push(&ring, &item));
+    for (uint32_t i = 0; i < 4; i++) {
+        EXPECT(ring_pop(&ring, &item) && item.seq == 100 + i);
+    }
+    EXPECT(ring.head == 2 && ring.tail == 2);
+}
+
+static void *producer(void *arg) {
+    Stress *s = arg;
+
+    for (uint32_t seq = 0; seq < STRESS_ITEMS; seq++) {
+        Item item = make_item(seq);
+        while (!ring_push(&s->ring, &item) && s->retry) {
+            sched_yield();      // Single-core hosts: let the consumer run
+        }
+        if (!s->retry && (seq % 24) == 0) {
+            sched_yield();      // Bursts, so both sides interleave on any core count
+        }
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg) {
+    Stress *s = arg;
+    uint32_t next = 0;
+    Item item;
+
+    // The last item is never dropped by a retrying producer; in drop mode
+    // stop once everything was either received or refused
+    while (next < STRESS_ITEMS) {
+        if (!ring_pop(&s->ring, &item)) {
+            if (!s->retry && s->received + s->ring.dropped == STRESS_ITEMS && ring_count(&s->ring) == 0) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        s->received++;
+        if (!item_ok(&item)) {
+            s->corrupted++;
+        }
+        if (item.seq < next || (s->retry && item.seq != next)) {
+            s->out_of_order++;
+        }
+        next = item.seq + 1;
+    }
+    return NULL;
+}
+
+static void run_stress(int retry) {
+    static Stress s;
+    pthread_t prod, cons;
+
+    memset(&s, 0, sizeof(s));
+    s.retry = retry;
+    EXPECT(ring_init(&s.ring, s.storage, sizeof(Item), STRESS_CAPACITY));
+
+    pthread_create(&cons, NULL, consumer, &s);
+    pthread_create(&prod, NULL, producer, &s);
+    pthread_join(prod, NULL);
+    pthread_join(cons, NULL);
+
+    printf("%s: %u received, %u refused, %u out of order, %u corrupted\n",
+           retry ? "retry" : "drop ", s.received, s.ring.dropped, s.out_of_order, s.corrupted);
+    EXPECT(s.out_of_order == 0);
+    EXPECT(s.corrupted == 0);
+    if (retry) {
+        EXPECT(s.received == STRESS_ITEMS);     // dropped counts the retried pushes here
+    } else {
+        EXPECT(s.received + s.ring.dropped == STRESS_ITEMS);
+        EXPECT(s.received > 0);
+    }
+}
+
+/* ========================== */
+/*        BYTE STREAMS        */
+/* ========================== */
+
+// Message: length byte, 32-bit sequence number, then bytes derived from both
+static uint32_t make_message(uint32_t seq, uint8_t *msg) {
+    uint32_t len = 5 + (seq * 7U) % (STREAM_MAX_LEN - 4);
+    msg[0] = (uint8_t)len;
+    memcpy(&msg[1], &seq, sizeof(seq));
+    for (uint32_t i = 5; i < len; i++) {
+        msg[i] = (uint8_t)(seq + i);
+    }
+    return len;
+}
+
+static void test_stream_single_thread(void) {
+    Ring ring;
+    uint8_t storage[8];
+    const uint8_t *run;
+
+    EXPECT(ring_init(&ring, storage, 1, sizeof(storage)));
+    EXPECT(ring_peek(&ring, &run) == 0);
+    EXPECT(ring_write(&ring, "abcde", 5));
+    EXPECT(!ring_write(&ring, "fghi", 4));         // 3 free: refused whole
+    EXPECT(ring.dropped == 4 && ring_count(&ring) == 5);
+    EXPECT(ring_peek(&ring, &run) == 5 && memcmp(run, "abcde", 5) == 0);
+    ring_release(&ring, 5);
+
+    // Across the end of the storage: the run stops there, the rest follows
+    EXPECT(ring_write(&ring, "123456", 6));
+    EXPECT(ring_peek(&ring, &run) == 3 && memcmp(run, "123", 3) == 0);
+    ring_release(&ring, 2);
+    EXPECT(ring_peek(&ring, &run) == 1 && run[0] == '3');
+    ring_release(&ring, 1);
+    EXPECT(ring_peek(&ring, &run) == 3 && memcmp(run, "456", 3) == 0);
+    ring_release(&ring, 3);
+    EXPECT(ring_count(&ring) == 0);
+}
+
+typedef struct {
+    Ring ring;
+    uint8_t storage[STREAM_CAPACITY];
+    uint32_t written;
+    volatile int done;
+    uint32_t received;
+    uint32_t out_of_order;
+    uint32_t corrupted;
+} Stream;
+
+static void *stream_producer(void *arg) {
+    Stream *s = arg;
+    uint8_t msg[STREAM_MAX_LEN];
+
+    for (uint32_t seq = 0; seq < STREAM_MESSAGES; seq++) {
+        uint32_t len = make_message(seq, msg);
+        s->written += ring_write(&s->ring, msg, len);
+        if ((seq % 16) == 0) {
+            sched_yield();
+        }
+    }
+    s->done = 1;
+    return NULL;
+}
+
+static void *stream_consumer(void *arg) {
+    Stream *s = arg;
+    uint8_t msg[STREAM_MAX_LEN], expect[STREAM_MAX_LEN];
+    uint32_t have = 0, next = 0;
+    const uint8_t *run;
+    uint32_t n;
+
+    for (;;) {
+        n = ring_peek(&s->ring, &run);
+        if (n == 0) {
+            if (s->done && ring_count(&s->ring) == 0) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        // Take the run in odd-sized pieces, like DMA transfers of any length
+        if (n > 13) {
+            n = 13;
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            msg[have++] = run[i];
+            if (have < 5 || have < msg[0]) {
+                continue;
+            }
+            uint32_t seq;
+            memcpy(&seq, &msg[1], sizeof(seq));
+            if (make_message(seq, expect) != msg[0] || memcmp(msg, expect, msg[0]) != 0) {
+                s->corrupted++;
+            }
+            if (seq < next) {
+                s->out_of_order++;
+            }
+            next = seq + 1;
+            s->received++;
+            have = 0;
+        }
+        ring_release(&s->ring, n);
+    }
+    return NULL;
+}
+
+static void run_stream_stress(void) {
+    static Stream s;
+    pthread_t prod, cons;
+
+    memset(&s, 0, sizeof(s));
+    EXPECT(ring_init(&s.ring, s.storage, 1, STREAM_CAPACITY));
+
+    pthread_create(&cons, NULL, stream_consumer, &s);
+    pthread_create(&prod, NULL, stream_producer, &s);
+    pthread_join(prod, NULL);
+    pthread_join(cons, NULL);
+
+    printf("bytes: %u messages received, %u bytes dropped, %u out of order, %u corrupted\n",
+           s.received, s.ring.dropped, s.out_of_order, s.corrupted);
+    EXPECT(s.received == s.written);
+    EXPECT(s.received > 0);
+    EXPECT(s.out_of_order == 0);
+    EXPECT(s.corrupted == 0);
+}
+
+int main(void) {
+    test_single_thread();
+    test_stream_single_thread();
+    run_stress(1);
+    run_stress(0);
+    run_stream_stress();
+    printf("ring_stress: %s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
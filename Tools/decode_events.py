@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+"""
+decode_events.py
+
+Converts eventsNNN.bin files written by event_log.c (or a raw capture of
+ITM stimulus port 1 with --raw) back to the TIMESTAMP,LOG_LEVEL,MESSAGE
+layout of logsNNN.csv. The record layout is described in
+Core/Inc/tools_h/event_log.h, the messages come from the token dictionary.
+Compressed eventsNNN.lz files (EVENT_LOG_COMPRESSION) are read as well.
+Version 2 records carry a CRC-8: after a damaged or lost stretch the decoder
+slides byte by byte to the next record that checks out.
+
+Usage:
+    decode_events.py EVENTS001.BIN [-d log_tokens.json] [-o logs001.csv]
+"""
+
+import argparse
+import struct
+import sys
+
+import log_dictionary
+import lz_decompress
+
+EVENT_LOG_MAGIC = 0x56454D41
+
+HEADER_FMT = "<IHHH24sH"
+HEADER_SIZE = struct.calcsize(HEADER_FMT)
+RECORD_FMT = "<BHI"
+RECORD_HEADER = struct.calcsize(RECORD_FMT)
+
+EVENT_LOG_VERSION = 2
+
+TOKEN_TIME_HIGH = 0x00
+TOKEN_TEXT = 0x01
+
+CSV_HEADER = "TIMESTAMP,TIME_S,LOG_LEVEL,MESSAGE"
+
+
+def crc16_ccitt(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def format_timestamp(timestamp_us):
+    timestamp_ms = timestamp_us // 1000
+    hour, rem = divmod(timestamp_ms, 3600 * 1000)
+    minute, rem = divmod(rem, 60 * 1000)
+    sec, ms = divmod(rem, 1000)
+    seconds, us = divmod(timestamp_us, 1000000)
+    return "%02u:%02u:%02u:%03u,%u.%06u" % (hour % 100, minute, sec, ms, seconds, us)
+
+
+def unpack_args(signature, payload):
+    values = []
+    pos = 0
+    for kind in signature:
+        if kind == "s":
+            n = payload[pos]
+            values.append(payload[pos + 1:pos + 1 + n].decode("utf-8", "replace"))
+            pos += 1 + n
+        else:
+            values.append(struct.unpack_from({"f": "<f", "i": "<i", "u": "<I"}[kind], payload, pos)[0])
+            pos += 4
+    if pos != len(payload):
+        raise ValueError("%d argument bytes, %d expected" % (len(payload), pos))
+    return values
+
+
+def read_header(data):
+    if len(data) < HEADER_SIZE:
+        raise ValueError("file too short for an event log header")
+    magic, version, header_size, token_count, firmware, crc = struct.unpack_from(HEADER_FMT, data, 0)
+    if magic != EVENT_LOG_MAGIC:
+        raise ValueError("bad magic 0x%08X" % magic)
+    if crc16_ccitt(data[:HEADER_SIZE - 2]) != crc:
+        raise ValueError("header CRC mismatch")
+    if version not in (1, EVENT_LOG_VERSION):
+        raise ValueError("unsupported event log version %d" % version)
+    sys.stderr.write("firmware: %s, version %d, %d tokens\n"
+                     % (firmware.rstrip(b"\0").decode("ascii", "replace"), version, token_count))
+    return header_size, version, token_count
+
+
+def decode(data, tokens, out, raw=False):
+    offset = 0
+    version = EVENT_LOG_VERSION     # SWV captures come from the current firmware
+    if not raw:
+        offset, version, token_count = read_header(data)
+        if token_count != len(tokens):
+            sys.stderr.write("warning: firmware has %d tokens, dictionary %d\n" % (token_count, len(tokens)))
+    crc_size = 1 if version >= 2 else 0
+
+    out.write(CSV_HEADER + "\r\n")
+    time_high = 0
+    good = unknown = damaged = skipped = 0
+    synced = True
+    while offset + RECORD_HEADER + crc_size <= len(data):
+        length, token, time_low = struct.unpack_from(RECORD_FMT, data, offset)
+        end = offset + RECORD_HEADER + length + crc_size
+        entry = tokens.get(token)
+        try:
+            if end > len(data):
+                raise ValueError("record runs past the end of the data")
+            if crc_size and crc8(data[offset:end - 1]) != data[end - 1]:
+                raise ValueError("CRC mismatch")
+            args = unpack_args(entry["args"], data[offset + RECORD_HEADER:end - crc_size]) if entry else None
+        except ValueError as err:
+            if not crc_size:
+                # Version 1 records cannot be put back in step: keep what was decoded
+                sys.stderr.write("token 0x%02X at offset %d: %s, stopping\n" % (token, offset, err))
+                damaged += 1
+                break
+            # Lost buffer or damaged record: slide to the next record whose CRC checks out
+            if synced:
+                damaged += 1
+                synced = False
+            skipped += 1
+            offset += 1
+            continue
+        synced = True
+        offset = end
+
+        if entry is None:
+            unknown += 1    # The length byte still keeps us in step
+            continue
+        if token == TOKEN_TIME_HIGH:
+            time_high = args[0]
+            continue
+        if token == TOKEN_TEXT:
+            level, message = args
+        else:
+            level, message = entry["level"], entry["format"] % tuple(args)
+        good += 1
+        out.write("%s,%s,%s\r\n" % (format_timestamp((time_high << 32) | time_low), level, message))
+
+    trailing = len(data) - offset
+    sys.stderr.write("%d events decoded, %d unknown tokens, %d damaged regions (%d bytes skipped), "
+                     "%d trailing bytes\n" % (good, unknown, damaged, skipped, trailing))
+    return unknown == 0 and damaged == 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode Atmos tokenized events to CSV")
+    parser.add_argument("input", help="eventsNNN.bin or .lz file from the SD card, or an ITM port 1 capture")
+    parser.add_argument("-d", "--dict", default=log_dictionary.DEFAULT_HEADER,
+                        help="log_tokens.json from the build, or log_tokens.h (default: the source tree)")
+    parser.add_argument("-o", "--output", help="CSV output file (default: stdout)")
+    parser.add_argument("--raw", action="store_true", help="input has no file header (SWV capture)")
+    args = parser.parse_args()
+
+    try:
+        tokens = log_dictionary.load(args.dict)
+    except (OSError, ValueError) as err:
+        sys.stderr.write("%s: %s\n" % (args.dict, err))
+        return 2
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+    if not args.raw and lz_decompress.is_lz(data):
+        try:
+            data, _ = lz_decompress.decompress(data)
+        except ValueError as err:
+            sys.stderr.write("%s: %s\n" % (args.input, err))
+            return 2
+
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    try:
+        ok = decode(data, tokens, out, args.raw)
+    except ValueError as err:
+        sys.stderr.write("%s: %s\n" % (args.input, err))
+        return 2
+    finally:
+        if out is not sys.stdout:
+            out.close()
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
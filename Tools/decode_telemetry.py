@@ -0,0 +1,271 @@
+#!/usr/bin/env python3
+"""
+decode_telemetry.py
+
+Converts telemetryNNN.bin files written by black_box.c back to the CSV layout
+of telemetryNNN.csv. The binary layout is described in
+Core/Inc/tools_h/telemetry.h; version 4 files hold the keyframe + delta
+records of TELEMETRY_COMPRESSION.
+
+Usage:
+    decode_telemetry.py TELEMETRY001.BIN [-o telemetry001.csv]
+"""
+
+import argparse
+import struct
+import sys
+
+TELEMETRY_BIN_MAGIC = 0x534D5441
+
+HEADER_FMT = "<IHHHH24sH"
+HEADER_SIZE = struct.calcsize(HEADER_FMT)
+
+RECORD_FORMATS = {
+    1: "<I10fH",    # timestamp in milliseconds
+    2: "<Q10fH",    # timestamp in microseconds
+    3: "<Q11fH",    # + mics5524_voltage
+}
+
+PACKED_VERSION = 4
+PACKED_KEYFRAME = 0x80
+PACKED_FIELD_COUNT = 11
+PACKED_SCALES = (100.0, 10.0, 100.0, 10.0, 10.0, 1.0, 1.0, 1.0, 100.0, 100.0, 10000.0)  # TELEMETRY_PACKED_SCALES
+PACKED_NAN = -0x80000000
+
+TIMESTAMP_US_PER_TICK = {
+    1: 1000,
+    2: 1,
+    3: 1,
+}
+
+CSV_HEADER = ("TIMESTAMP,TIME_S,ms5607_temperature,ms5607_pressure,ms5607_altitude,"
+              "sds011_pm2_5,sds011_pm10,ens160_AQI,ens160_TVOC,ens160_eCO2,"
+              "aht21_temperature,aht21_humidity,mics5524_voltage")
+
+
+def crc16_ccitt(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def format_timestamp(timestamp_us):
+    timestamp_ms = timestamp_us // 1000
+    hour, rem = divmod(timestamp_ms, 3600 * 1000)
+    minute, rem = divmod(rem, 60 * 1000)
+    sec, ms = divmod(rem, 1000)
+    seconds, us = divmod(timestamp_us, 1000000)
+    return "%02u:%02u:%02u:%03u,%u.%06u" % (hour % 100, minute, sec, ms, seconds, us)
+
+
+def read_varint(buf, pos):
+    value = shift = 0
+    while True:
+        if pos >= len(buf):
+            raise ValueError("truncated varint")
+        byte = buf[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def to_int32(value):
+    return ((value + 0x80000000) & 0xFFFFFFFF) - 0x80000000
+
+
+class PackedDecoder:
+    """Replays telemetry_encode(): state only advances on a fully parsed record."""
+
+    def __init__(self):
+        self.values = None
+        self.timestamp = 0
+        self.interval = 0
+
+    def record(self, body, keyframe):
+        pos = 0
+        if keyframe:
+            timestamp, pos = read_varint(body, pos)
+            interval = 0
+            values = []
+            for _ in range(PACKED_FIELD_COUNT):
+                value, pos = read_varint(body, pos)
+                values.append(to_int32(unzigzag(value)))
+        else:
+            if self.values is None:
+                raise ValueError("delta record without a keyframe")
+            change, pos = read_varint(body, pos)
+            interval = self.interval + unzigzag(change)
+            timestamp = self.timestamp + interval
+            if pos + 2 > len(body):
+                raise ValueError("truncated field mask")
+            mask = body[pos] | (body[pos + 1] << 8)
+            pos += 2
+            values = list(self.values)
+            for i in range(PACKED_FIELD_COUNT):
+                if mask & (1 << i):
+                    delta, pos = read_varint(body, pos)
+                    values[i] = to_int32(values[i] + unzigzag(delta))
+        if pos != len(body) or timestamp < self.timestamp:
+            raise ValueError("inconsistent record")
+        self.values, self.timestamp, self.interval = values, timestamp, interval
+        return timestamp, values
+
+
+def is_erased(tail):
+    return tail in (b"\xff" * len(tail), b"\x00" * len(tail))
+
+
+def decode_packed(data, offset, out):
+    decoder = PackedDecoder()
+    good = damaged = skipped = 0
+    synced = False
+
+    while offset < len(data):
+        end = offset + (data[offset] & 0x7F) + 2
+        keyframe = bool(data[offset] & PACKED_KEYFRAME)
+        raw = data[offset:end]
+        if len(raw) == end - offset and crc8(raw[:-1]) == raw[-1]:
+            if synced or keyframe:
+                try:
+                    timestamp, values = decoder.record(raw[1:-1], keyframe)
+                except ValueError:
+                    pass
+                else:
+                    synced = True
+                    good += 1
+                    offset = end
+                    out.write("%s,%s\r\n" % (format_timestamp(timestamp),
+                              ",".join("nan" if v == PACKED_NAN else "%.2f" % (v / scale)
+                                       for v, scale in zip(values, PACKED_SCALES))))
+                    continue
+
+        if is_erased(data[offset:]):
+            # Erased tail of a preallocated file that was never truncated (power loss)
+            sys.stderr.write("erased space from offset %d, stopping\n" % offset)
+            offset = len(data)
+            break
+        if len(raw) < end - offset:
+            break
+
+        # Damaged record: deltas mean nothing until the next keyframe, which is
+        # searched byte by byte in case the length byte itself was hit
+        if synced:
+            damaged += 1
+            synced = False
+        skipped += 1
+        offset += 1
+
+    trailing = len(data) - offset
+    sys.stderr.write("%d records decoded, %d damaged regions (%d bytes skipped), %d trailing bytes\n"
+                     % (good, damaged, skipped, trailing))
+    return damaged == 0
+
+
+def decode(data, out):
+    if len(data) < HEADER_SIZE:
+        raise ValueError("file too short for a telemetry header")
+
+    magic, version, header_size, record_size, field_count, firmware, crc = \
+        struct.unpack_from(HEADER_FMT, data, 0)
+    if magic != TELEMETRY_BIN_MAGIC:
+        raise ValueError("bad magic 0x%08X" % magic)
+    if crc16_ccitt(data[:HEADER_SIZE - 2]) != crc:
+        raise ValueError("header CRC mismatch")
+    if version != PACKED_VERSION and version not in RECORD_FORMATS:
+        raise ValueError("unsupported telemetry version %d" % version)
+
+    if version == PACKED_VERSION:
+        sys.stderr.write("firmware: %s, version %d (packed), %d fields\n"
+                         % (firmware.rstrip(b"\0").decode("ascii", "replace"), version, field_count))
+        if field_count != PACKED_FIELD_COUNT:
+            raise ValueError("%d fields, this decoder knows %d" % (field_count, PACKED_FIELD_COUNT))
+        out.write(CSV_HEADER + "\r\n")
+        return decode_packed(data, header_size, out)
+
+    record_fmt = RECORD_FORMATS[version]
+    us_per_tick = TIMESTAMP_US_PER_TICK[version]
+    if struct.calcsize(record_fmt) != record_size:
+        raise ValueError("record size %d does not match version %d" % (record_size, version))
+
+    sys.stderr.write("firmware: %s, version %d, %d fields\n"
+                     % (firmware.rstrip(b"\0").decode("ascii", "replace"), version, field_count))
+
+    # Older versions stop before the columns added later
+    value_count = len(struct.unpack(record_fmt, bytes(record_size))) - 2
+    out.write(",".join(CSV_HEADER.split(",")[:2 + value_count]) + "\r\n")
+
+    good = damaged = skipped = 0
+    synced = True
+    offset = header_size
+    while offset + record_size <= len(data):
+        raw = data[offset:offset + record_size]
+        fields = struct.unpack(record_fmt, raw)
+        if crc16_ccitt(raw[:-2]) == fields[-1]:
+            synced = True
+            good += 1
+            offset += record_size
+            values = ",".join("%.2f" % v for v in fields[1:-1])
+            out.write("%s,%s\r\n" % (format_timestamp(fields[0] * us_per_tick), values))
+            continue
+
+        if is_erased(data[offset:]):
+            # Erased tail of a preallocated file that was never truncated (power loss)
+            sys.stderr.write("erased space from offset %d, stopping\n" % offset)
+            offset = len(data)
+            break
+
+        # Damaged or cut record (a write failure drops whole buffers, not whole
+        # records): slide byte by byte until the records line up again
+        if synced:
+            damaged += 1
+            synced = False
+        skipped += 1
+        offset += 1
+
+    trailing = len(data) - offset
+    sys.stderr.write("%d records decoded, %d damaged regions (%d bytes skipped), %d trailing bytes\n"
+                     % (good, damaged, skipped, trailing))
+    return damaged == 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode Atmos binary telemetry to CSV")
+    parser.add_argument("input", help="telemetryNNN.bin file from the SD card")
+    parser.add_argument("-o", "--output", help="CSV output file (default: stdout)")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    try:
+        ok = decode(data, out)
+    except ValueError as err:
+        sys.stderr.write("%s: %s\n" % (args.input, err))
+        return 2
+    finally:
+        if out is not sys.stdout:
+            out.close()
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
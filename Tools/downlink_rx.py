@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""
+downlink_rx.py
+
+Ground-side receiver for the telemetry downlink (downlink.c): reads the
+COBS-framed stream from a serial port, a pty or a capture file, checks each
+frame's CRC and writes the samples as CSV in the units of telemetryNNN.csv.
+The frame layout is described in Core/Inc/tools_h/downlink.h.
+
+Without a radio, feed it from the host benchmark:
+    flight_bench -l /tmp/downlink.bin && downlink_rx.py /tmp/downlink.bin
+or live through a pty pair:
+    socat -d -d pty,raw,echo=0,link=/tmp/atmos pty,raw,echo=0,link=/tmp/ground &
+    flight_bench -l /tmp/atmos & downlink_rx.py /tmp/ground
+
+Usage:
+    downlink_rx.py PORT_OR_FILE [-b 115200] [-o downlink.csv]
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+FRAME_TELEMETRY = 0x01
+FRAME_FMT = "<BBHIIhiHHBHHhHHH"
+FRAME_SIZE = struct.calcsize(FRAME_FMT)
+
+CSV_HEADER = ("TIMESTAMP,TIME_S,SEQ,DECIMATION,ms5607_temperature,ms5607_pressure,ms5607_altitude,"
+              "sds011_pm2_5,sds011_pm10,ens160_AQI,ens160_TVOC,ens160_eCO2,"
+              "aht21_temperature,aht21_humidity,mics5524_voltage")
+
+
+def crc16_ccitt(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    pos = 0
+    while pos < len(data):
+        code = data[pos]
+        block = data[pos + 1:pos + code]
+        if code == 0 or len(block) != code - 1:
+            raise ValueError("truncated COBS block")
+        out += block
+        pos += code
+        if code != 0xFF and pos < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def format_timestamp(time_ms):
+    hour, rem = divmod(time_ms, 3600 * 1000)
+    minute, rem = divmod(rem, 60 * 1000)
+    sec, ms = divmod(rem, 1000)
+    return "%02u:%02u:%02u:%03u,%u.%03u" % (hour % 100, minute, sec, ms, time_ms // 1000, time_ms % 1000)
+
+
+class Receiver:
+    def __init__(self, out):
+        self.out = out
+        self.pending = bytearray()
+        self.good = self.bad_crc = self.bad_frame = self.lost = 0
+        self.last_seq = None
+        out.write(CSV_HEADER + "\r\n")
+
+    def feed(self, chunk):
+        self.pending += chunk
+        while True:
+            end = self.pending.find(b"\0")
+            if end < 0:
+                return
+            encoded = bytes(self.pending[:end])
+            del self.pending[:end + 1]
+            if encoded:
+                self.frame(encoded)
+
+    def frame(self, encoded):
+        try:
+            frame = cobs_decode(encoded)
+        except ValueError:
+            self.bad_frame += 1
+            return
+        if len(frame) != FRAME_SIZE or frame[0] != FRAME_TELEMETRY:
+            self.bad_frame += 1     # Joined mid-frame, or a frame type this receiver does not know
+            return
+        if crc16_ccitt(frame[:-2]) != struct.unpack_from("<H", frame, FRAME_SIZE - 2)[0]:
+            self.bad_crc += 1
+            return
+
+        (_, decimation, seq, time_ms, pressure, temperature, altitude, pm2_5, pm10, aqi, tvoc, eco2,
+         aht_temperature, aht_humidity, mics_mv, _) = struct.unpack(FRAME_FMT, frame)
+        if self.last_seq is not None:
+            self.lost += (seq - self.last_seq - 1) & 0xFFFF
+        self.last_seq = seq
+        self.good += 1
+        self.out.write("%s,%u,%u,%.2f,%.1f,%.2f,%.1f,%.1f,%u,%u,%u,%.2f,%.2f,%.3f\r\n" % (
+            format_timestamp(time_ms), seq, decimation,
+            temperature / 100.0, pressure / 10.0, altitude / 100.0,
+            pm2_5 / 10.0, pm10 / 10.0, aqi, tvoc, eco2,
+            aht_temperature / 100.0, aht_humidity / 100.0, mics_mv / 1000.0))
+
+    def summary(self):
+        return ("%d frames, %d CRC errors, %d malformed, %d lost (sequence gaps)"
+                % (self.good, self.bad_crc, self.bad_frame, self.lost))
+
+
+def open_input(path, baud):
+    fd = os.open(path, os.O_RDONLY | getattr(os, "O_NOCTTY", 0))
+    if os.isatty(fd):
+        import termios
+        import tty
+        tty.setraw(fd)
+        attrs = termios.tcgetattr(fd)
+        speed = getattr(termios, "B%d" % baud, None)
+        if speed is None:
+            raise ValueError("unsupported baud rate %d" % baud)
+        attrs[4] = attrs[5] = speed
+        termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return fd
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Receive the Atmos telemetry downlink")
+    parser.add_argument("input", help="serial device (e.g. /dev/ttyUSB0), pty or capture file")
+    parser.add_argument("-b", "--baud", type=int, default=115200, help="serial baud rate (default: 115200)")
+    parser.add_argument("-o", "--output", help="CSV output file (default: stdout)")
+    args = parser.parse_args()
+
+    try:
+        fd = open_input(args.input, args.baud)
+    except (OSError, ValueError) as err:
+        sys.stderr.write("%s: %s\n" % (args.input, err))
+        return 2
+
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    rx = Receiver(out)
+    try:
+        while True:
+            chunk = os.read(fd, 4096)
+            if not chunk:
+                break           # End of a capture file, or the other end of the pty closed
+            rx.feed(chunk)
+            out.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        os.close(fd)
+        if out is not sys.stdout:
+            out.close()
+    sys.stderr.write(rx.summary() + "\n")
+    return 0 if rx.bad_crc == 0 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""
+log_dictionary.py
+
+Extracts the tokenized event dictionary (LOG_TOKEN_TABLE in
+Core/Inc/tools_h/log_tokens.h) into a JSON file for decode_events.py, so a
+flight's events can be decoded with the dictionary of the firmware that
+recorded them. The host build regenerates it on every build.
+
+Usage:
+    log_dictionary.py [Core/Inc/tools_h/log_tokens.h] [-o log_tokens.json]
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+DEFAULT_HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                              "..", "Core", "Inc", "tools_h", "log_tokens.h")
+
+ENTRY_RE = re.compile(r'X\(\s*(0x[0-9A-Fa-f]+|\d+)\s*,\s*(\w+)\s*,\s*"([^"]*)"\s*,'
+                      r'\s*"([fius]*)"\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+
+
+def parse_header(path=DEFAULT_HEADER):
+    """Returns {id: {"name", "level", "args", "format"}}."""
+    with open(path) as f:
+        text = f.read()
+
+    start = text.find("#define LOG_TOKEN_TABLE")
+    if start < 0:
+        raise ValueError("%s: no LOG_TOKEN_TABLE" % path)
+    # The table is one macro: continuation lines up to the first line without a backslash
+    lines = []
+    for line in text[start:].splitlines():
+        lines.append(line)
+        if not line.rstrip().endswith("\\"):
+            break
+
+    tokens = {}
+    for match in ENTRY_RE.finditer("\n".join(lines)):
+        token = int(match.group(1), 0)
+        if token in tokens:
+            raise ValueError("%s: token 0x%02X used twice" % (path, token))
+        fmt = match.group(5).encode().decode("unicode_escape")
+        tokens[token] = {"name": match.group(2), "level": match.group(3),
+                         "args": match.group(4), "format": fmt}
+    if not tokens:
+        raise ValueError("%s: empty LOG_TOKEN_TABLE" % path)
+    return tokens
+
+
+def load(path):
+    """Loads a dictionary from a JSON file or straight from the header."""
+    if path.endswith(".h"):
+        return parse_header(path)
+    with open(path) as f:
+        return {int(k, 0): v for k, v in json.load(f)["tokens"].items()}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Extract the Atmos event token dictionary")
+    parser.add_argument("header", nargs="?", default=DEFAULT_HEADER, help="log_tokens.h")
+    parser.add_argument("-o", "--output", help="JSON output file (default: stdout)")
+    args = parser.parse_args()
+
+    try:
+        tokens = parse_header(args.header)
+    except (OSError, ValueError) as err:
+        sys.stderr.write("%s\n" % err)
+        return 2
+
+    doc = {"tokens": {"0x%02X" % k: tokens[k] for k in sorted(tokens)}}
+    text = json.dumps(doc, indent=2) + "\n"
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
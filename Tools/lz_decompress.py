@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+lz_decompress.py
+
+Restores eventsNNN.lz / logsNNN.lz files written with EVENT_LOG_COMPRESSION
+to the eventsNNN.bin / logsNNN.csv they stand for. The stream format is
+described in Core/Inc/tools_h/lz_stream.h. decode_events.py reads .lz files
+directly through decompress().
+
+Usage:
+    lz_decompress.py EVENTS001.LZ [-o events001.bin]
+"""
+
+import argparse
+import struct
+import sys
+
+LZ_FILE_MAGIC = 0x5A4C4D41
+LZ_MIN_MATCH = 3
+
+HEADER_FMT = "<IHH"
+HEADER_SIZE = struct.calcsize(HEADER_FMT)
+
+
+def is_lz(data):
+    return len(data) >= HEADER_SIZE and struct.unpack_from("<I", data, 0)[0] == LZ_FILE_MAGIC
+
+
+def find_header(data, start):
+    """Offset of the next lz_file_header_t at or after start, len(data) if none."""
+    magic = struct.pack("<I", LZ_FILE_MAGIC)
+    pos = data.find(magic, start)
+    while pos >= 0:
+        if pos + HEADER_SIZE <= len(data) and struct.unpack_from(HEADER_FMT, data, pos)[1] == 1:
+            return pos
+        pos = data.find(magic, pos + 1)
+    return len(data)
+
+
+def decompress_stream(data, pos, end, window_size, out):
+    """Appends one stream's output; returns True if it ended on a group boundary."""
+    start = len(out)
+    while pos < end:
+        flags = data[pos]
+        pos += 1
+        for bit in range(8):
+            if pos >= end:
+                # Cut inside a group: power lost or a write failed before the last sync
+                return False
+            if not flags & (1 << bit):
+                out.append(data[pos])
+                pos += 1
+                continue
+            if pos + 2 > end:
+                return False
+            offset = data[pos] | ((data[pos + 1] & 0x07) << 8)
+            length = (data[pos + 1] >> 3) + LZ_MIN_MATCH
+            pos += 2
+            if offset == 0:
+                break                   # Sync marker: the rest of the group is empty
+            if offset > len(out) - start or offset >= window_size:
+                raise ValueError("match %d bytes back at output offset %d" % (offset, len(out)))
+            for _ in range(length):     # Byte by byte: a match may overlap its own output
+                out.append(out[-offset])
+    return True
+
+
+def decompress(data):
+    """Returns (plain bytes, True if every stream ended on a group boundary).
+
+    A file reopened after a write failure holds several streams, each behind
+    its own header. A stream that is cut or damaged keeps what it decoded, and
+    decoding restarts at the next header.
+    """
+    if not is_lz(data):
+        raise ValueError("not an lz file")
+    _, version, window_size = struct.unpack_from(HEADER_FMT, data, 0)
+    if version != 1:
+        raise ValueError("unsupported lz version %d" % version)
+
+    out = bytearray()
+    complete = True
+    pos = 0
+    while pos < len(data):
+        end = find_header(data, pos + HEADER_SIZE)
+        damage = None
+        try:
+            clean = decompress_stream(data, pos + HEADER_SIZE, end, window_size, out)
+        except ValueError as err:
+            clean, damage = False, str(err)
+        if damage or (not clean and end < len(data)):
+            sys.stderr.write("lz stream at offset %d %s%s\n"
+                             % (pos, "damaged: " + damage if damage else "cut inside a group",
+                                ", restarting at offset %d" % end if end < len(data) else ""))
+        complete = complete and clean
+        pos = end
+    return bytes(out), complete
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decompress Atmos .lz event logs")
+    parser.add_argument("input", help="eventsNNN.lz or logsNNN.lz file from the SD card")
+    parser.add_argument("-o", "--output", help="output file (default: stdout)")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+    try:
+        plain, complete = decompress(data)
+    except ValueError as err:
+        sys.stderr.write("%s: %s\n" % (args.input, err))
+        return 2
+
+    if args.output:
+        with open(args.output, "wb") as f:
+            f.write(plain)
+    else:
+        sys.stdout.buffer.write(plain)
+    sys.stderr.write("%d -> %d bytes%s\n" % (len(data), len(plain), "" if complete else ", truncated stream"))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())